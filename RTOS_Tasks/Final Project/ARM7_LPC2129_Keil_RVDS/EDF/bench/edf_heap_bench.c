@@ -0,0 +1,148 @@
+/*
+ * Host benchmark for the EDF ready queue.
+ *
+ * Compares the deadline sorted list used by the original EDF patch (modelled
+ * on vListInsert(): linear walk from the head, O(1) removal) with the binary
+ * heap in edf_heap.c.  Every step picks the task with the earliest deadline,
+ * removes it and releases its next job, which is the work the scheduler does
+ * once per job.  Both queues must pick the same task at every step.
+ *
+ * Build and run on the host:
+ *     gcc -O2 -I.. edf_heap_bench.c ../edf_heap.c -o edf_heap_bench
+ *     ./edf_heap_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "edf_heap.h"
+
+#define benchMAX_TASKS		( 128 )
+#define benchSTEPS			( 2000000UL )
+
+typedef struct xBENCH_TASK
+{
+	uint32_t ulPeriod;
+	EDFHeapItem_t xHeapItem;
+
+	/* Sorted list links, kept in the same struct as a TCB would. */
+	uint32_t ulListDeadline;
+	struct xBENCH_TASK * pxNext;
+	struct xBENCH_TASK * pxPrevious;
+
+} BenchTask_t;
+
+static BenchTask_t xTasks[ benchMAX_TASKS ];
+static BenchTask_t xListEnd;
+static EDFHeap_t xHeap;
+static EDFHeapItem_t * pxHeapStorage[ benchMAX_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+/* Same walk as vListInsert(): stop at the first item with a later value so
+that equal deadlines stay in release order. */
+static void prvListInsert( BenchTask_t * pxTask )
+{
+BenchTask_t * pxIterator = &xListEnd;
+
+	while( ( pxIterator->pxNext != &xListEnd ) && ( pxIterator->pxNext->ulListDeadline <= pxTask->ulListDeadline ) )
+	{
+		pxIterator = pxIterator->pxNext;
+	}
+
+	pxTask->pxNext = pxIterator->pxNext;
+	pxTask->pxPrevious = pxIterator;
+	pxIterator->pxNext->pxPrevious = pxTask;
+	pxIterator->pxNext = pxTask;
+}
+/*-----------------------------------------------------------*/
+
+static void prvListRemove( BenchTask_t * pxTask )
+{
+	pxTask->pxPrevious->pxNext = pxTask->pxNext;
+	pxTask->pxNext->pxPrevious = pxTask->pxPrevious;
+}
+/*-----------------------------------------------------------*/
+
+static double prvSeconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( double ) xNow.tv_sec + ( ( double ) xNow.tv_nsec * 1e-9 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateTaskSet( unsigned uxTasks )
+{
+unsigned i;
+
+	srand( 1234U );
+
+	xListEnd.pxNext = &xListEnd;
+	xListEnd.pxPrevious = &xListEnd;
+	vEDFHeapInitialise( &xHeap, pxHeapStorage, benchMAX_TASKS );
+
+	for( i = 0; i < uxTasks; i++ )
+	{
+		xTasks[ i ].ulPeriod = 5U + ( uint32_t ) ( rand() % 500 );
+
+		xTasks[ i ].ulListDeadline = xTasks[ i ].ulPeriod;
+		prvListInsert( &xTasks[ i ] );
+
+		vEDFHeapInitialiseItem( &xTasks[ i ].xHeapItem, &xTasks[ i ] );
+		xTasks[ i ].xHeapItem.ulDeadline = xTasks[ i ].ulPeriod;
+		( void ) ucEDFHeapInsert( &xHeap, &xTasks[ i ].xHeapItem );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvRun( unsigned uxTasks )
+{
+double dStart, dListNs, dHeapNs;
+unsigned long ulStep;
+BenchTask_t * pxTask;
+uint32_t ulListChecksum = 0U, ulHeapChecksum = 0U;
+
+	prvCreateTaskSet( uxTasks );
+
+	dStart = prvSeconds();
+	for( ulStep = 0; ulStep < benchSTEPS; ulStep++ )
+	{
+		pxTask = xListEnd.pxNext;
+		ulListChecksum = ( ulListChecksum * 31U ) + ( uint32_t ) ( pxTask - xTasks );
+		prvListRemove( pxTask );
+		pxTask->ulListDeadline += pxTask->ulPeriod;
+		prvListInsert( pxTask );
+	}
+	dListNs = ( ( prvSeconds() - dStart ) * 1e9 ) / ( double ) benchSTEPS;
+
+	dStart = prvSeconds();
+	for( ulStep = 0; ulStep < benchSTEPS; ulStep++ )
+	{
+		pxTask = ( BenchTask_t * ) pxEDFHeapPeek( &xHeap )->pvOwner;
+		ulHeapChecksum = ( ulHeapChecksum * 31U ) + ( uint32_t ) ( pxTask - xTasks );
+		( void ) ucEDFHeapSetDeadline( &xHeap, &pxTask->xHeapItem, pxTask->xHeapItem.ulDeadline + pxTask->ulPeriod );
+	}
+	dHeapNs = ( ( prvSeconds() - dStart ) * 1e9 ) / ( double ) benchSTEPS;
+
+	printf( "%5u tasks: sorted list %8.1f ns/job   heap %8.1f ns/job   speedup %5.2fx%s\n",
+			uxTasks, dListNs, dHeapNs, dListNs / dHeapNs,
+			( ulListChecksum == ulHeapChecksum ) ? "" : "   SCHEDULE MISMATCH" );
+
+	return ( ulListChecksum == ulHeapChecksum ) ? 0 : 1;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+int iErrors = 0;
+
+	iErrors += prvRun( 8U );
+	iErrors += prvRun( 32U );
+	iErrors += prvRun( 128U );
+
+	return iErrors;
+}
+/*-----------------------------------------------------------*/
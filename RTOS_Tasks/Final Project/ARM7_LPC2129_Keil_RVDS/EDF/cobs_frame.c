@@ -0,0 +1,171 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Peripheral includes. */
+#include "serial.h"
+
+#include "cobs_frame.h"
+
+/*-----------------------------------------------------------*/
+
+#define cobsDELIMITER			( ( uint8_t ) 0x00 )
+
+/* Longest run a code byte can announce, code 0xff. */
+#define cobsMAX_RUN				( 254U )
+
+/*-----------------------------------------------------------*/
+
+static volatile uint32_t ulFrameErrors = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xCobsFrameSend( const void * pvData, unsigned short usLength )
+{
+const uint8_t * pucData = ( const uint8_t * ) pvData;
+const uint32_t ulEncoded = cobsENCODED_LENGTH( ( uint32_t ) usLength );
+BaseType_t xReturn = pdFALSE;
+unsigned short usRun;
+uint8_t ucCode;
+
+	if( ( pucData == NULL ) && ( usLength > 0U ) )
+	{
+		return pdFALSE;
+	}
+
+	/* Other writers are held off until the delimiter is queued, and the ISR
+	only frees space, so the pieces below cannot be refused once the whole
+	frame was found to fit. */
+	vTaskSuspendAll();
+	{
+		if( ulEncoded <= ( uint32_t ) usSerialGetTxFree() )
+		{
+			for( ;; )
+			{
+				usRun = 0U;
+				while( ( usRun < cobsMAX_RUN ) && ( usRun < usLength ) && ( pucData[ usRun ] != cobsDELIMITER ) )
+				{
+					usRun++;
+				}
+
+				ucCode = ( uint8_t ) ( usRun + 1U );
+				( void ) vSerialPutString( ( const signed char * ) &ucCode, 1U );
+				if( usRun > 0U )
+				{
+					( void ) vSerialPutString( ( const signed char * ) pucData, usRun );
+				}
+
+				pucData += usRun;
+				usLength -= usRun;
+
+				if( usLength == 0U )
+				{
+					break;
+				}
+
+				/* Below code 0xff the piece stopped at a zero, which the code
+				byte stands for. */
+				if( usRun < cobsMAX_RUN )
+				{
+					pucData++;
+					usLength--;
+
+					if( usLength == 0U )
+					{
+						/* A trailing zero still needs the empty piece
+						after it. */
+						ucCode = 0x01U;
+						( void ) vSerialPutString( ( const signed char * ) &ucCode, 1U );
+						break;
+					}
+				}
+			}
+
+			ucCode = cobsDELIMITER;
+			( void ) vSerialPutString( ( const signed char * ) &ucCode, 1U );
+			xReturn = pdTRUE;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vCobsFrameSetReceiver( TaskHandle_t xTask )
+{
+	vSerialSetRxFrameTask( xTask );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCobsFrameReceive( void * pvFrame, unsigned short usMax, unsigned short * pusLength, TickType_t xTicksToWait )
+{
+uint8_t * pucFrame = ( uint8_t * ) pvFrame;
+unsigned short usRead, usEnd, usIn = 0U, usOut = 0U;
+uint8_t ucCode, x;
+
+	configASSERT( ( pucFrame != NULL ) && ( usMax > 0U ) && ( pusLength != NULL ) );
+
+	/* One notification per delimiter in the ring, so the whole frame is
+	there once this returns. */
+	if( ulTaskNotifyTake( pdFALSE, xTicksToWait ) == 0U )
+	{
+		return pdFALSE;
+	}
+
+	usRead = usSerialReadFrame( ( signed char * ) pucFrame, usMax );
+	if( ( usRead == 0U ) || ( pucFrame[ usRead - 1U ] != cobsDELIMITER ) )
+	{
+		/* Too long for the buffer: the rest of it goes too. */
+		while( ( usRead != 0U ) && ( pucFrame[ usRead - 1U ] != cobsDELIMITER ) )
+		{
+			usRead = usSerialReadFrame( ( signed char * ) pucFrame, usMax );
+		}
+
+		ulFrameErrors++;
+		return pdFALSE;
+	}
+
+	usEnd = usRead - 1U;
+	if( usEnd == 0U )
+	{
+		/* A lone delimiter, as a sender may use to flush the line: nothing
+		to decode and nothing wrong. */
+		return pdFALSE;
+	}
+
+	/* The output never catches up with the input, so the frame is decoded
+	over itself. */
+	while( usIn < usEnd )
+	{
+		ucCode = pucFrame[ usIn++ ];
+
+		if( ( unsigned short ) ( ucCode - 1U ) > ( unsigned short ) ( usEnd - usIn ) )
+		{
+			/* A code byte pointing past the delimiter. */
+			ulFrameErrors++;
+			return pdFALSE;
+		}
+
+		for( x = 1U; x < ucCode; x++ )
+		{
+			pucFrame[ usOut++ ] = pucFrame[ usIn++ ];
+		}
+
+		if( ( ucCode != 0xffU ) && ( usIn < usEnd ) )
+		{
+			pucFrame[ usOut++ ] = cobsDELIMITER;
+		}
+	}
+
+	*pusLength = usOut;
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCobsFrameGetErrors( void )
+{
+	return ulFrameErrors;
+}
+/*-----------------------------------------------------------*/
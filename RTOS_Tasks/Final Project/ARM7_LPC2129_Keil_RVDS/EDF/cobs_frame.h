@@ -0,0 +1,57 @@
+#ifndef COBS_FRAME_H
+#define COBS_FRAME_H
+
+/*
+ * Packet framing over UART1 with COBS (Consistent Overhead Byte Stuffing).
+ *
+ * COBS removes every 0x00 from a packet: the packet is cut at its zeros and
+ * each piece is sent as a code byte, its length + 1, followed by its bytes.
+ * Pieces longer than 254 bytes are split with code 0xff, which stands for
+ * 254 bytes and no zero.  A single 0x00 then ends the frame, so a receiver
+ * finds the boundaries by looking at one byte at a time and can pick up the
+ * stream anywhere.  The cost is one byte per 254 plus the delimiter.
+ *
+ * Sending encodes straight into the driver's transmit ring: the code bytes
+ * and the runs of packet bytes between zeros are queued one after the other,
+ * with no encoded copy of the packet in between.
+ *
+ * Receiving relies on the driver's ISR, which notifies the receiving task
+ * once for every delimiter it stores (vSerialSetRxFrameTask()), so the task
+ * only wakes for complete frames.  The frame is then decoded in place in the
+ * caller's buffer.  A frame must fit in the driver's receive ring,
+ * configSERIAL_RX_BUFFER_SIZE, and the ISR drops any that does not, all of
+ * it, so the frames after it still arrive intact.
+ *
+ * COBS does not check the content.  Packets that matter should carry their
+ * own CRC, as bytes lost to a UART FIFO overrun can merge two frames into one
+ * that still decodes.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Longest frame on the wire for a packet of xLength bytes, delimiter included.
+It is also the buffer size xCobsFrameReceive() needs for such a packet. */
+#define cobsENCODED_LENGTH( xLength )	( ( xLength ) + ( ( xLength ) / 254U ) + 2U )
+
+/************ Function declaration section ***********/
+
+/* Queues usLength bytes at pvData as one frame, or returns pdFALSE and queues
+nothing when the transmit ring cannot take cobsENCODED_LENGTH( usLength )
+bytes.  Never blocks, and the packet can be reused as soon as it returns. */
+extern BaseType_t xCobsFrameSend( const void * pvData, unsigned short usLength );
+
+/* Makes xTask the one woken by received frames.  Call before the first
+xCobsFrameReceive(), from that task or before the scheduler starts. */
+extern void vCobsFrameSetReceiver( TaskHandle_t xTask );
+
+/* Waits up to xTicksToWait for the next complete frame and decodes it into
+pvFrame, which must hold usMax bytes.  Returns pdTRUE with the packet length
+in *pusLength, or pdFALSE on timeout and for frames that were longer than
+usMax or did not decode, which are dropped and counted. */
+extern BaseType_t xCobsFrameReceive( void * pvFrame, unsigned short usMax, unsigned short * pusLength, TickType_t xTicksToWait );
+
+/* Received frames dropped as too long or badly encoded. */
+extern uint32_t ulCobsFrameGetErrors( void );
+
+#endif /* COBS_FRAME_H */
@@ -0,0 +1,133 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "lpc21xx.h"
+
+#include "cpu_burn.h"
+
+/*-----------------------------------------------------------*/
+
+/* The calibration doubles the loop count until it covers at least this much
+time, and at least burnMIN_CALIBRATION_COUNTS Timer1 counts, which keeps the
+quantisation error of the measurement below 0.1%. */
+#define burnCALIBRATION_MS				( 20UL )
+#define burnMIN_CALIBRATION_COUNTS		( 1000UL )
+#define burnFIRST_CALIBRATION_LOOPS		( 1024UL )
+#define burnMAX_CALIBRATION_LOOPS		( 0x40000000UL )
+
+#define burnT1TCR_COUNTER_ENABLE		( 0x01UL )
+
+/*-----------------------------------------------------------*/
+
+static uint32_t ulLoopsPerMs = 0;
+
+static void prvSpin( uint32_t ulLoops );
+static uint32_t prvTimer1Hz( void );
+
+/*-----------------------------------------------------------*/
+
+void vBurnCpuCalibrate( void )
+{
+uint32_t ulLoops = burnFIRST_CALIBRATION_LOOPS;
+uint32_t ulTimerHz, ulMinCounts, ulStart, ulElapsed;
+
+	if( ( T1TCR & burnT1TCR_COUNTER_ENABLE ) == 0U )
+	{
+		T1TCR = burnT1TCR_COUNTER_ENABLE;
+	}
+
+	ulTimerHz = prvTimer1Hz();
+	ulMinCounts = ( ulTimerHz / 1000UL ) * burnCALIBRATION_MS;
+	if( ulMinCounts < burnMIN_CALIBRATION_COUNTS )
+	{
+		ulMinCounts = burnMIN_CALIBRATION_COUNTS;
+	}
+
+	for( ;; )
+	{
+		/* Start right after a count edge so only the end of the measurement
+		is quantised. */
+		ulStart = T1TC;
+		while( T1TC == ulStart )
+		{
+		}
+		ulStart++;
+
+		prvSpin( ulLoops );
+		ulElapsed = T1TC - ulStart;
+
+		if( ( ulElapsed >= ulMinCounts ) || ( ulLoops >= burnMAX_CALIBRATION_LOOPS ) )
+		{
+			break;
+		}
+
+		ulLoops <<= 1;
+	}
+
+	if( ulElapsed == 0U )
+	{
+		ulElapsed = 1U;
+	}
+
+	/* Done once, so the 64 bit division is acceptable here. */
+	ulLoopsPerMs = ( uint32_t ) ( ( ( uint64_t ) ulLoops * ulTimerHz ) / ( ( uint64_t ) ulElapsed * 1000U ) );
+}
+/*-----------------------------------------------------------*/
+
+void vBurnCpuMicroseconds( uint32_t ulMicroseconds )
+{
+uint32_t ulWholeMs = ulMicroseconds / 1000UL;
+
+	configASSERT( ulLoopsPerMs != 0U );
+
+	/* One millisecond at a time so the loop count cannot overflow. */
+	while( ulWholeMs > 0U )
+	{
+		prvSpin( ulLoopsPerMs );
+		ulWholeMs--;
+	}
+
+	prvSpin( ( ( ulMicroseconds % 1000UL ) * ulLoopsPerMs ) / 1000UL );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBurnCpuGetLoopsPerMs( void )
+{
+	return ulLoopsPerMs;
+}
+/*-----------------------------------------------------------*/
+
+/* The calibration and the burner must run exactly this loop.  The counter
+is volatile so the compiler can neither remove nor unroll it. */
+static void prvSpin( uint32_t ulLoops )
+{
+volatile uint32_t ulCount = ulLoops;
+
+	while( ulCount != 0U )
+	{
+		ulCount--;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimer1Hz( void )
+{
+uint32_t ulPclk;
+
+	switch( VPBDIV & 0x03UL )
+	{
+		case 1:
+			ulPclk = configCPU_CLOCK_HZ;
+			break;
+
+		case 2:
+			ulPclk = configCPU_CLOCK_HZ / 2UL;
+			break;
+
+		default:
+			ulPclk = configCPU_CLOCK_HZ / 4UL;
+			break;
+	}
+
+	return ulPclk / ( T1PR + 1UL );
+}
+/*-----------------------------------------------------------*/
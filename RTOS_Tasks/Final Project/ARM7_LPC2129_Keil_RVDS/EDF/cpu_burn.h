@@ -0,0 +1,33 @@
+#ifndef CPU_BURN_H
+#define CPU_BURN_H
+
+/*
+ * Calibrated CPU burner, used by the demo tasks to simulate execution time.
+ *
+ * vBurnCpuCalibrate() times a fixed spin loop against Timer1 once at boot,
+ * so the result follows the compiler flags, MAM setup and ARM/Thumb mode of
+ * the build that is actually running.  vBurnCpuMicroseconds() then runs the
+ * loop for the requested number of microseconds of CPU time.  The budget is
+ * counted in loop iterations, which only advance while the caller is
+ * running, so time spent preempted by other tasks or inside ISRs is not
+ * counted and the task always consumes the same amount of CPU.
+ *
+ * Timer1 only needs to be running during the calibration.  Its rate is read
+ * back from VPBDIV and T1PR, and it is started with the current prescaler
+ * if the application has not started it yet.
+ */
+
+#include <stdint.h>
+
+/************ Function declaration section ***********/
+
+/* Call once before vTaskStartScheduler(), with interrupts still disabled.  Takes about 40ms. */
+extern void vBurnCpuCalibrate( void );
+
+/* Consumes ulMicroseconds of CPU time of the calling task. */
+extern void vBurnCpuMicroseconds( uint32_t ulMicroseconds );
+
+/* Spin loop iterations per millisecond found by the calibration. */
+extern uint32_t ulBurnCpuGetLoopsPerMs( void );
+
+#endif /* CPU_BURN_H */
@@ -0,0 +1,209 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lpc21xx.h"
+
+#include "task_trace.h"
+#include "task_monitor.h"
+#include "cpu_load.h"
+
+/*-----------------------------------------------------------*/
+
+#define loadRING_LENGTH			( configLOAD_WINDOW_SUBDIVISIONS + 1 )
+
+/* Keeps ulCount * 1000 inside 32 bits when converting to parts per 1000. */
+#define loadMAX_SCALED_COUNT	( ( uint32_t ) 0x003fffffUL )
+
+typedef struct
+{
+	uint32_t ulTime;									/* T1TC when the snapshot was taken. */
+	uint32_t ulExecution[ monitorNUMBER_OF_SLOTS ];		/* xTaskExecution[].ulTotalExecution at ulTime. */
+
+} LoadSnapshot_t;
+
+typedef struct
+{
+	uint32_t ulSpacing;			/* Timer1 counts between snapshots. */
+	uint32_t ulNextSnapshot;
+	UBaseType_t uxHead;			/* Next entry to overwrite, also the oldest once the ring is full. */
+	UBaseType_t uxUsed;
+	LoadSnapshot_t xRing[ loadRING_LENGTH ];
+
+} LoadWindow_t;
+
+/*-----------------------------------------------------------*/
+
+/* Earliest ulNextSnapshot of all windows, compared by traceTASK_SWITCHED_OUT. */
+uint32_t ulCPULoadNextSnapshot = 0;
+
+static const uint32_t ulWindowsMs[ configLOAD_NUMBER_OF_WINDOWS ] = configLOAD_WINDOWS_MS;
+static LoadWindow_t xWindows[ configLOAD_NUMBER_OF_WINDOWS ];
+
+static void prvTakeSnapshot( LoadWindow_t * pxWindow, uint32_t ulNow );
+static void prvUpdateNextSnapshot( void );
+
+/* Execution of one slot up to ulNow, including the slice that is running. */
+static uint32_t prvLiveExecution( UBaseType_t uxSlot, uint32_t ulNow );
+static uint32_t prvPerMille( uint32_t ulPart, uint32_t ulWhole );
+
+/*-----------------------------------------------------------*/
+
+void vCPULoadInit( void )
+{
+UBaseType_t x;
+uint32_t ulNow = T1TC;
+
+	for( x = 0; x < configLOAD_NUMBER_OF_WINDOWS; x++ )
+	{
+		xWindows[ x ].ulSpacing = ( ( ulWindowsMs[ x ] * ( configTRACE_TIMER_HZ / 10UL ) ) / 100UL ) / configLOAD_WINDOW_SUBDIVISIONS;
+		xWindows[ x ].uxHead = 0;
+		xWindows[ x ].uxUsed = 0;
+		xWindows[ x ].ulNextSnapshot = ulNow;
+		prvTakeSnapshot( &xWindows[ x ], ulNow );
+	}
+
+	prvUpdateNextSnapshot();
+}
+/*-----------------------------------------------------------*/
+
+/* Called from traceTASK_SWITCHED_OUT, after the outgoing task's counter has
+been updated, so every counter is exact at ulNow. */
+void vCPULoadSnapshot( uint32_t ulNow )
+{
+UBaseType_t x;
+
+	for( x = 0; x < configLOAD_NUMBER_OF_WINDOWS; x++ )
+	{
+		if( ( int32_t ) ( ulNow - xWindows[ x ].ulNextSnapshot ) >= 0 )
+		{
+			prvTakeSnapshot( &xWindows[ x ], ulNow );
+		}
+	}
+
+	prvUpdateNextSnapshot();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCPULoadGetTotal( UBaseType_t uxWindow )
+{
+const LoadSnapshot_t * pxOldest;
+uint32_t ulNow, ulElapsed, ulIdle;
+
+	if( uxWindow >= configLOAD_NUMBER_OF_WINDOWS )
+	{
+		return 0;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		pxOldest = &xWindows[ uxWindow ].xRing[ ( xWindows[ uxWindow ].uxUsed < loadRING_LENGTH ) ? 0 : xWindows[ uxWindow ].uxHead ];
+		ulNow = T1TC;
+		ulElapsed = ulNow - pxOldest->ulTime;
+		ulIdle = prvLiveExecution( monitorIDLE_SLOT, ulNow ) - pxOldest->ulExecution[ monitorIDLE_SLOT ];
+	}
+	taskEXIT_CRITICAL();
+
+	if( ulIdle > ulElapsed )
+	{
+		ulIdle = ulElapsed;
+	}
+
+	return prvPerMille( ulElapsed - ulIdle, ulElapsed );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCPULoadGetTask( UBaseType_t uxSlot, UBaseType_t uxWindow )
+{
+const LoadSnapshot_t * pxOldest;
+uint32_t ulNow, ulElapsed, ulExecution;
+
+	if( ( uxWindow >= configLOAD_NUMBER_OF_WINDOWS ) || ( uxSlot >= monitorNUMBER_OF_SLOTS ) )
+	{
+		return 0;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		pxOldest = &xWindows[ uxWindow ].xRing[ ( xWindows[ uxWindow ].uxUsed < loadRING_LENGTH ) ? 0 : xWindows[ uxWindow ].uxHead ];
+		ulNow = T1TC;
+		ulElapsed = ulNow - pxOldest->ulTime;
+		ulExecution = prvLiveExecution( uxSlot, ulNow ) - pxOldest->ulExecution[ uxSlot ];
+	}
+	taskEXIT_CRITICAL();
+
+	return prvPerMille( ulExecution, ulElapsed );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeSnapshot( LoadWindow_t * pxWindow, uint32_t ulNow )
+{
+LoadSnapshot_t * pxSnapshot = &pxWindow->xRing[ pxWindow->uxHead ];
+UBaseType_t x;
+
+	pxSnapshot->ulTime = ulNow;
+	for( x = 0; x < monitorNUMBER_OF_SLOTS; x++ )
+	{
+		pxSnapshot->ulExecution[ x ] = xTaskExecution[ x ].ulTotalExecution;
+	}
+
+	if( ++pxWindow->uxHead >= loadRING_LENGTH )
+	{
+		pxWindow->uxHead = 0;
+	}
+	if( pxWindow->uxUsed < loadRING_LENGTH )
+	{
+		pxWindow->uxUsed++;
+	}
+
+	/* If no switch happened for a long time, restart the spacing from now
+	rather than taking a burst of back to back snapshots. */
+	pxWindow->ulNextSnapshot += pxWindow->ulSpacing;
+	if( ( int32_t ) ( ulNow - pxWindow->ulNextSnapshot ) >= 0 )
+	{
+		pxWindow->ulNextSnapshot = ulNow + pxWindow->ulSpacing;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateNextSnapshot( void )
+{
+uint32_t ulNext = xWindows[ 0 ].ulNextSnapshot;
+UBaseType_t x;
+
+	for( x = 1; x < configLOAD_NUMBER_OF_WINDOWS; x++ )
+	{
+		if( ( int32_t ) ( xWindows[ x ].ulNextSnapshot - ulNext ) < 0 )
+		{
+			ulNext = xWindows[ x ].ulNextSnapshot;
+		}
+	}
+
+	ulCPULoadNextSnapshot = ulNext;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLiveExecution( UBaseType_t uxSlot, uint32_t ulNow )
+{
+uint32_t ulExecution = xTaskExecution[ uxSlot ].ulTotalExecution;
+
+	if( uxSlot == ulTaskExecutionCurrentSlot )
+	{
+		ulExecution += ulNow - xTaskExecution[ uxSlot ].ulSwitchInTime;
+	}
+
+	return ulExecution;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPerMille( uint32_t ulPart, uint32_t ulWhole )
+{
+	/* Scale both down together rather than use a 64 bit division. */
+	while( ulWhole > loadMAX_SCALED_COUNT )
+	{
+		ulPart >>= 1;
+		ulWhole >>= 1;
+	}
+
+	return ( ulWhole == 0U ) ? 0U : ( ( ulPart * 1000U ) / ulWhole );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,53 @@
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+/*
+ * Sliding window CPU load, total and per task, in integer arithmetic.
+ *
+ * The context switch hooks already keep a running execution counter per
+ * task slot (task_trace.h).  Every window keeps a small ring of snapshots
+ * of those counters, taken every window / configLOAD_WINDOW_SUBDIVISIONS,
+ * and the load is the counter delta over the Timer1 time since the oldest
+ * snapshot.  Snapshots are taken from traceTASK_SWITCHED_OUT when a
+ * boundary has passed, which costs one compare per switch, and nothing is
+ * done in the tick interrupt.  Timer1 wrap-around is handled by unsigned
+ * subtraction, so windows only need to be shorter than one Timer1 period.
+ *
+ * Loads are returned in parts per 1000.  The total load is everything that
+ * is not the idle task's slot, monitorIDLE_SLOT: periodic tasks and untagged
+ * tasks such as the timer task and the UART server.  Interrupts count for
+ * the task they interrupt.  The
+ * idle hook must call vTaskMonitorIdleHook() for the idle task to get that
+ * slot; until then the total reads 1000.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_monitor.h"
+
+#ifndef configLOAD_WINDOWS_MS
+	#define configLOAD_WINDOWS_MS				{ 100, 1000, 10000 }
+	#define configLOAD_NUMBER_OF_WINDOWS		( 3 )
+#endif
+
+#ifndef configLOAD_WINDOW_SUBDIVISIONS
+	#define configLOAD_WINDOW_SUBDIVISIONS		( 4 )
+#endif
+
+/* Window indexes for the default configLOAD_WINDOWS_MS. */
+#define loadWINDOW_100MS		( 0 )
+#define loadWINDOW_1S			( 1 )
+#define loadWINDOW_10S			( 2 )
+
+/************ Function declaration section ***********/
+
+/* Call once before vTaskStartScheduler(), after Timer1 has been started. */
+extern void vCPULoadInit( void );
+
+/* Total load of everything but the idle task over window uxWindow, in parts per 1000. */
+extern uint32_t ulCPULoadGetTotal( UBaseType_t uxWindow );
+
+/* Load of the task in monitor slot uxSlot over window uxWindow, in parts per 1000. */
+extern uint32_t ulCPULoadGetTask( UBaseType_t uxSlot, UBaseType_t uxWindow );
+
+#endif /* CPU_LOAD_H */
@@ -0,0 +1,397 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "edf_admission.h"
+#include "task_monitor.h"
+
+/*-----------------------------------------------------------*/
+
+/* Utilisations are fixed point with 16 fractional bits, 1.0 == 65536. */
+#define admUTILISATION_SHIFT		( 16 )
+#define admUTILISATION_ONE			( ( uint32_t ) 1UL << admUTILISATION_SHIFT )
+
+/* All times are handled in microseconds. */
+#define admUS_PER_TICK				( ( uint32_t ) ( 1000000UL / configTICK_RATE_HZ ) )
+
+/* The demand test gives up (and rejects) rather than run for too long. */
+#define admMAX_TEST_LENGTH_US		( ( uint32_t ) 0x7fffffffUL )
+#define admMAX_BUSY_ITERATIONS		( 64 )
+
+typedef struct
+{
+	uint32_t ulPeriod;
+	uint32_t ulDeadline;
+	uint32_t ulWcet;
+	uint32_t ulUtilisation;
+	uint8_t ucInUse;
+
+} AdmittedTask_t;
+
+/*-----------------------------------------------------------*/
+
+static AdmittedTask_t xAdmittedTasks[ configEDF_MAX_PERIODIC_TASKS ];
+
+/* Running sums over the admitted tasks, updated on every admit/release. */
+static uint32_t ulTotalUtilisation = 0;		/* sum( C/T ), fixed point. */
+static uint32_t ulTotalWcet = 0;			/* sum( C ). */
+static uint64_t ullSlackDemand = 0;			/* sum( ( T - D ) * C/T ), fixed point. */
+static UBaseType_t uxConstrainedTasks = 0;	/* Tasks with D < T. */
+
+/*
+ * Processor demand h(t): execution that must complete by time t when all
+ * tasks are released together at time 0.
+ */
+static uint64_t prvDemand( uint32_t ulTime );
+
+/* Latest absolute deadline that is strictly before ulTime, 0 if none. */
+static uint32_t prvLatestDeadlineBefore( uint32_t ulTime );
+
+/* Length of the interval the demand test must cover, 0 if it is unbounded or
+the busy period did not converge within admMAX_BUSY_ITERATIONS. */
+static uint32_t prvTestLength( uint32_t ulUtilisation, uint64_t ullSlack );
+
+/* QPA over the tasks currently marked in use. */
+static BaseType_t prvDemandTestPasses( uint32_t ulUtilisation, uint64_t ullSlack );
+
+/*
+ * Creates the task and registers it with the task monitor before it can run,
+ * so that its tag and deadline are in place for its first job.
+ */
+static BaseType_t prvCreateMonitoredTask( TaskFunction_t pxTaskCode,
+										  const char * const pcName,
+										  unsigned short usStackDepth,
+										  void * const pvParameters,
+										  UBaseType_t uxPriority,
+										  TaskHandle_t * const pxCreatedTask,
+										  TickType_t xPeriod,
+										  TickType_t xDeadline );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xEDFAdmissionRequest( TickType_t xPeriod, TickType_t xDeadline, uint32_t ulWcetUs, UBaseType_t * puxSlot )
+{
+AdmittedTask_t * pxTask = NULL;
+uint32_t ulPeriod, ulDeadline, ulUtilisation, ulNewTotal;
+uint64_t ullNewSlack;
+UBaseType_t uxSlot;
+BaseType_t xReturn = errEDF_TASK_SET_NOT_FEASIBLE;
+
+	if( xDeadline == ( TickType_t ) 0 )
+	{
+		xDeadline = xPeriod;
+	}
+
+	/* Deadlines longer than the period are not supported by the demo
+	kernel, and a job longer than its deadline can never fit. */
+	ulPeriod = ( uint32_t ) xPeriod * admUS_PER_TICK;
+	ulDeadline = ( uint32_t ) xDeadline * admUS_PER_TICK;
+	if( ( xPeriod == ( TickType_t ) 0 ) || ( xDeadline > xPeriod ) || ( ulWcetUs == 0U ) || ( ulWcetUs > ulDeadline ) )
+	{
+		return errEDF_TASK_SET_NOT_FEASIBLE;
+	}
+
+	/* Round up so that the bound stays safe. */
+	ulUtilisation = ( uint32_t ) ( ( ( ( uint64_t ) ulWcetUs << admUTILISATION_SHIFT ) + ulPeriod - 1U ) / ulPeriod );
+
+	vTaskSuspendAll();
+	{
+		for( uxSlot = 0; uxSlot < configEDF_MAX_PERIODIC_TASKS; uxSlot++ )
+		{
+			if( xAdmittedTasks[ uxSlot ].ucInUse == 0U )
+			{
+				pxTask = &xAdmittedTasks[ uxSlot ];
+				break;
+			}
+		}
+
+		ulNewTotal = ulTotalUtilisation + ulUtilisation;
+
+		if( ( pxTask != NULL ) && ( ulNewTotal <= admUTILISATION_ONE ) )
+		{
+			pxTask->ulPeriod = ulPeriod;
+			pxTask->ulDeadline = ulDeadline;
+			pxTask->ulWcet = ulWcetUs;
+			pxTask->ulUtilisation = ulUtilisation;
+			pxTask->ucInUse = 1U;
+
+			ullNewSlack = ullSlackDemand + ( ( uint64_t ) ( ulPeriod - ulDeadline ) * ulUtilisation );
+			ulTotalWcet += ulWcetUs;
+
+			/* With implicit deadlines only, U <= 1 is exact.  Otherwise run
+			the demand test on the set that includes the new task. */
+			if( ( ( uxConstrainedTasks == 0U ) && ( ulDeadline == ulPeriod ) ) ||
+				( prvDemandTestPasses( ulNewTotal, ullNewSlack ) == pdTRUE ) )
+			{
+				ulTotalUtilisation = ulNewTotal;
+				ullSlackDemand = ullNewSlack;
+				if( ulDeadline != ulPeriod )
+				{
+					uxConstrainedTasks++;
+				}
+
+				*puxSlot = uxSlot;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				pxTask->ucInUse = 0U;
+				ulTotalWcet -= ulWcetUs;
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vEDFAdmissionRelease( UBaseType_t uxSlot )
+{
+AdmittedTask_t * pxTask;
+
+	if( uxSlot >= configEDF_MAX_PERIODIC_TASKS )
+	{
+		return;
+	}
+
+	vTaskSuspendAll();
+	{
+		pxTask = &xAdmittedTasks[ uxSlot ];
+
+		if( pxTask->ucInUse != 0U )
+		{
+			pxTask->ucInUse = 0U;
+			ulTotalUtilisation -= pxTask->ulUtilisation;
+			ulTotalWcet -= pxTask->ulWcet;
+			ullSlackDemand -= ( uint64_t ) ( pxTask->ulPeriod - pxTask->ulDeadline ) * pxTask->ulUtilisation;
+
+			if( pxTask->ulDeadline != pxTask->ulPeriod )
+			{
+				uxConstrainedTasks--;
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulEDFAdmissionGetUtilisation( void )
+{
+	return ( uint32_t ) ( ( ( uint64_t ) ulTotalUtilisation * 1000U ) >> admUTILISATION_SHIFT );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskPeriodicCreateChecked( TaskFunction_t pxTaskCode,
+									   const char * const pcName,
+									   unsigned short usStackDepth,
+									   void * const pvParameters,
+									   UBaseType_t uxPriority,
+									   TaskHandle_t * const pxCreatedTask,
+									   TickType_t xPeriod,
+									   TickType_t xDeadline,
+									   uint32_t ulWcetUs )
+{
+BaseType_t xReturn;
+
+	#if ( configUSE_EDF_ADMISSION_CONTROL == 1 )
+	{
+	UBaseType_t uxSlot;
+
+		xReturn = xEDFAdmissionRequest( xPeriod, xDeadline, ulWcetUs, &uxSlot );
+
+		if( xReturn == pdPASS )
+		{
+			xReturn = prvCreateMonitoredTask( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, xPeriod, xDeadline );
+
+			if( xReturn != pdPASS )
+			{
+				vEDFAdmissionRelease( uxSlot );
+			}
+		}
+	}
+	#else
+	{
+		( void ) ulWcetUs;
+		xReturn = prvCreateMonitoredTask( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, xPeriod, xDeadline );
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCreateMonitoredTask( TaskFunction_t pxTaskCode,
+										  const char * const pcName,
+										  unsigned short usStackDepth,
+										  void * const pvParameters,
+										  UBaseType_t uxPriority,
+										  TaskHandle_t * const pxCreatedTask,
+										  TickType_t xPeriod,
+										  TickType_t xDeadline )
+{
+BaseType_t xReturn;
+
+	vTaskSuspendAll();
+	{
+		xReturn = xTaskPeriodicCreate( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, xPeriod );
+
+		if( ( xReturn == pdPASS ) && ( pxCreatedTask != NULL ) )
+		{
+			( void ) uxTaskMonitorRegister( *pxCreatedTask, ( xDeadline == ( TickType_t ) 0 ) ? xPeriod : xDeadline );
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvDemand( uint32_t ulTime )
+{
+uint64_t ullDemand = 0;
+UBaseType_t x;
+
+	for( x = 0; x < configEDF_MAX_PERIODIC_TASKS; x++ )
+	{
+		if( ( xAdmittedTasks[ x ].ucInUse != 0U ) && ( xAdmittedTasks[ x ].ulDeadline <= ulTime ) )
+		{
+			ullDemand += ( uint64_t ) ( ( ( ulTime - xAdmittedTasks[ x ].ulDeadline ) / xAdmittedTasks[ x ].ulPeriod ) + 1U ) * xAdmittedTasks[ x ].ulWcet;
+		}
+	}
+
+	return ullDemand;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLatestDeadlineBefore( uint32_t ulTime )
+{
+uint32_t ulLatest = 0, ulCandidate;
+UBaseType_t x;
+
+	for( x = 0; x < configEDF_MAX_PERIODIC_TASKS; x++ )
+	{
+		if( ( xAdmittedTasks[ x ].ucInUse != 0U ) && ( xAdmittedTasks[ x ].ulDeadline < ulTime ) )
+		{
+			/* Largest k * T + D that is below ulTime. */
+			ulCandidate = ( ( ( ulTime - 1U - xAdmittedTasks[ x ].ulDeadline ) / xAdmittedTasks[ x ].ulPeriod ) * xAdmittedTasks[ x ].ulPeriod ) + xAdmittedTasks[ x ].ulDeadline;
+
+			if( ulCandidate > ulLatest )
+			{
+				ulLatest = ulCandidate;
+			}
+		}
+	}
+
+	return ulLatest;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTestLength( uint32_t ulUtilisation, uint64_t ullSlack )
+{
+uint32_t ulLength = 0, ulMaxDeadline = 0;
+uint64_t ullBusy, ullNext, ullBound;
+UBaseType_t x, uxIteration;
+BaseType_t xConverged = pdFALSE;
+
+	/* Synchronous busy period: w = sum( ceil( w / T ) * C ).  Only a fixed
+	point is a bound; an iterate cut short by the limit is too short and
+	would leave later deadlines unchecked. */
+	ullBusy = ulTotalWcet;
+	for( uxIteration = 0; uxIteration < admMAX_BUSY_ITERATIONS; uxIteration++ )
+	{
+		ullNext = 0;
+		for( x = 0; x < configEDF_MAX_PERIODIC_TASKS; x++ )
+		{
+			if( xAdmittedTasks[ x ].ucInUse != 0U )
+			{
+				ullNext += ( ( ullBusy + xAdmittedTasks[ x ].ulPeriod - 1U ) / xAdmittedTasks[ x ].ulPeriod ) * xAdmittedTasks[ x ].ulWcet;
+			}
+		}
+
+		if( ullNext == ullBusy )
+		{
+			xConverged = pdTRUE;
+			break;
+		}
+		if( ullNext > admMAX_TEST_LENGTH_US )
+		{
+			break;
+		}
+		ullBusy = ullNext;
+	}
+
+	if( ( xConverged != pdFALSE ) && ( ullBusy <= admMAX_TEST_LENGTH_US ) )
+	{
+		ulLength = ( uint32_t ) ullBusy;
+	}
+
+	/* La = max( Dmax, sum( ( T - D ) * U ) / ( 1 - U ) ), only defined for U < 1. */
+	if( ulUtilisation < admUTILISATION_ONE )
+	{
+		for( x = 0; x < configEDF_MAX_PERIODIC_TASKS; x++ )
+		{
+			if( ( xAdmittedTasks[ x ].ucInUse != 0U ) && ( xAdmittedTasks[ x ].ulDeadline > ulMaxDeadline ) )
+			{
+				ulMaxDeadline = xAdmittedTasks[ x ].ulDeadline;
+			}
+		}
+
+		ullBound = ullSlack / ( admUTILISATION_ONE - ulUtilisation );
+		if( ullBound < ulMaxDeadline )
+		{
+			ullBound = ulMaxDeadline;
+		}
+
+		if( ( ullBound <= admMAX_TEST_LENGTH_US ) && ( ( ulLength == 0U ) || ( ullBound < ulLength ) ) )
+		{
+			ulLength = ( uint32_t ) ullBound;
+		}
+	}
+
+	return ulLength;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDemandTestPasses( uint32_t ulUtilisation, uint64_t ullSlack )
+{
+uint32_t ulLength, ulTime, ulMinDeadline = 0xffffffffUL;
+uint64_t ullDemand;
+UBaseType_t x;
+
+	ulLength = prvTestLength( ulUtilisation, ullSlack );
+	if( ulLength == 0U )
+	{
+		return pdFALSE;
+	}
+
+	for( x = 0; x < configEDF_MAX_PERIODIC_TASKS; x++ )
+	{
+		if( ( xAdmittedTasks[ x ].ucInUse != 0U ) && ( xAdmittedTasks[ x ].ulDeadline < ulMinDeadline ) )
+		{
+			ulMinDeadline = xAdmittedTasks[ x ].ulDeadline;
+		}
+	}
+
+	/* QPA (Zhang and Burns): walk backwards from the end of the interval,
+	jumping straight to h(t) whenever there is spare capacity. */
+	ulTime = prvLatestDeadlineBefore( ulLength + 1U );
+	ullDemand = prvDemand( ulTime );
+
+	while( ( ullDemand <= ulTime ) && ( ullDemand > ulMinDeadline ) )
+	{
+		if( ullDemand < ulTime )
+		{
+			ulTime = ( uint32_t ) ullDemand;
+		}
+		else
+		{
+			ulTime = prvLatestDeadlineBefore( ulTime );
+		}
+
+		ullDemand = prvDemand( ulTime );
+	}
+
+	return ( ullDemand <= ulMinDeadline ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
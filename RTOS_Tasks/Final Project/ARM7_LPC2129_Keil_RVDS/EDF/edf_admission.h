@@ -0,0 +1,72 @@
+#ifndef EDF_ADMISSION_H
+#define EDF_ADMISSION_H
+
+/*
+ * Admission control for periodic EDF tasks.
+ *
+ * Every periodic task is described by its period T, relative deadline D
+ * (D <= T) and worst case execution time C.  A new task is only accepted
+ * when the whole set stays feasible under EDF:
+ *
+ *  - all deadlines implicit (D == T): utilisation bound, sum(C/T) <= 1.
+ *  - any constrained deadline (D < T): processor demand test, h(t) <= t for
+ *    every absolute deadline t up to the synchronous busy period, evaluated
+ *    with Quick Processor-demand Analysis (QPA) so only a handful of the
+ *    deadlines are visited.
+ *
+ * The utilisation sums are kept up to date as tasks are admitted and
+ * released, so the implicit deadline case costs O(1) and the demand test
+ * is only paid for when a constrained task is present.
+ *
+ * Set configUSE_EDF_ADMISSION_CONTROL to 0 to make xTaskPeriodicCreateChecked
+ * a plain xTaskPeriodicCreate call.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Returned by xTaskPeriodicCreateChecked when the task would make the set
+infeasible.  The task is not created in that case. */
+#define errEDF_TASK_SET_NOT_FEASIBLE	( -6 )
+
+#ifndef configUSE_EDF_ADMISSION_CONTROL
+	#define configUSE_EDF_ADMISSION_CONTROL		0
+#endif
+
+#ifndef configEDF_MAX_PERIODIC_TASKS
+	#define configEDF_MAX_PERIODIC_TASKS		( 8 )
+#endif
+
+/************ Function declaration section ***********/
+
+/*
+ * Tests the task set with the new task added.  On success the task is
+ * recorded, *puxSlot receives its slot and pdPASS is returned.  xDeadline of
+ * 0 means an implicit deadline.  Times are in ticks, the WCET in
+ * microseconds.
+ */
+extern BaseType_t xEDFAdmissionRequest( TickType_t xPeriod, TickType_t xDeadline, uint32_t ulWcetUs, UBaseType_t * puxSlot );
+
+/* Removes a task recorded by xEDFAdmissionRequest, e.g. before vTaskDelete. */
+extern void vEDFAdmissionRelease( UBaseType_t uxSlot );
+
+/* Total utilisation of the admitted tasks in parts per 1000. */
+extern uint32_t ulEDFAdmissionGetUtilisation( void );
+
+/*
+ * xTaskPeriodicCreate with an admission test in front of it.  Returns pdPASS,
+ * errEDF_TASK_SET_NOT_FEASIBLE or the error returned by xTaskPeriodicCreate.
+ * When pxCreatedTask is given the new task is also registered with the task
+ * monitor (task_monitor.h), which sets its task tag.
+ */
+extern BaseType_t xTaskPeriodicCreateChecked( TaskFunction_t pxTaskCode,
+											  const char * const pcName,
+											  unsigned short usStackDepth,
+											  void * const pvParameters,
+											  UBaseType_t uxPriority,
+											  TaskHandle_t * const pxCreatedTask,
+											  TickType_t xPeriod,
+											  TickType_t xDeadline,
+											  uint32_t ulWcetUs );
+
+#endif /* EDF_ADMISSION_H */
@@ -0,0 +1,182 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "edf_heap.h"
+
+/*-----------------------------------------------------------*/
+
+/* pxA must run before pxB.  Deadlines and sequence numbers are compared
+through a signed difference so that tick count overflow is handled. */
+#define edfheapIS_EARLIER( pxA, pxB )	\
+	( ( ( int32_t ) ( ( pxA )->ulDeadline - ( pxB )->ulDeadline ) < 0 ) || \
+	  ( ( ( pxA )->ulDeadline == ( pxB )->ulDeadline ) && \
+	    ( ( int32_t ) ( ( pxA )->ulSequence - ( pxB )->ulSequence ) < 0 ) ) )
+
+static void prvSiftUp( EDFHeap_t * pxHeap, uint16_t usIndex );
+static void prvSiftDown( EDFHeap_t * pxHeap, uint16_t usIndex );
+
+/*-----------------------------------------------------------*/
+
+void vEDFHeapInitialise( EDFHeap_t * pxHeap, EDFHeapItem_t ** ppxStorage, uint16_t usCapacity )
+{
+	pxHeap->ppxItems = ppxStorage;
+	pxHeap->usNumberOfItems = 0U;
+	pxHeap->usCapacity = usCapacity;
+	pxHeap->ulNextSequence = 0U;
+}
+/*-----------------------------------------------------------*/
+
+void vEDFHeapInitialiseItem( EDFHeapItem_t * pxItem, void * pvOwner )
+{
+	pxItem->ulDeadline = 0U;
+	pxItem->ulSequence = 0U;
+	pxItem->usHeapIndex = edfheapNOT_IN_HEAP;
+	pxItem->pvOwner = pvOwner;
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucEDFHeapInsert( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem )
+{
+uint16_t usIndex;
+
+	if( ( pxHeap->usNumberOfItems >= pxHeap->usCapacity ) || ( pxItem->usHeapIndex != edfheapNOT_IN_HEAP ) )
+	{
+		return 0U;
+	}
+
+	pxItem->ulSequence = pxHeap->ulNextSequence++;
+
+	usIndex = pxHeap->usNumberOfItems++;
+	pxHeap->ppxItems[ usIndex ] = pxItem;
+	pxItem->usHeapIndex = usIndex;
+
+	prvSiftUp( pxHeap, usIndex );
+
+	return 1U;
+}
+/*-----------------------------------------------------------*/
+
+void vEDFHeapRemove( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem )
+{
+uint16_t usIndex = pxItem->usHeapIndex;
+uint16_t usLast;
+EDFHeapItem_t * pxMoved;
+
+	if( usIndex == edfheapNOT_IN_HEAP )
+	{
+		return;
+	}
+
+	pxItem->usHeapIndex = edfheapNOT_IN_HEAP;
+	usLast = --pxHeap->usNumberOfItems;
+
+	if( usIndex != usLast )
+	{
+		/* Fill the hole with the last item, then restore the heap order in
+		whichever direction it was broken. */
+		pxMoved = pxHeap->ppxItems[ usLast ];
+		pxHeap->ppxItems[ usIndex ] = pxMoved;
+		pxMoved->usHeapIndex = usIndex;
+
+		if( ( usIndex > 0U ) && edfheapIS_EARLIER( pxMoved, pxHeap->ppxItems[ ( usIndex - 1U ) / 2U ] ) )
+		{
+			prvSiftUp( pxHeap, usIndex );
+		}
+		else
+		{
+			prvSiftDown( pxHeap, usIndex );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucEDFHeapSetDeadline( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem, uint32_t ulDeadline )
+{
+uint16_t usIndex = pxItem->usHeapIndex;
+
+	pxItem->ulDeadline = ulDeadline;
+
+	if( usIndex == edfheapNOT_IN_HEAP )
+	{
+		return ucEDFHeapInsert( pxHeap, pxItem );
+	}
+	else
+	{
+		/* A changed deadline counts as a new release, so it goes behind any
+		task that already holds the same deadline.  The item is moved in
+		place, which costs a single sift instead of a remove and insert. */
+		pxItem->ulSequence = pxHeap->ulNextSequence++;
+
+		if( ( usIndex > 0U ) && edfheapIS_EARLIER( pxItem, pxHeap->ppxItems[ ( usIndex - 1U ) / 2U ] ) )
+		{
+			prvSiftUp( pxHeap, usIndex );
+		}
+		else
+		{
+			prvSiftDown( pxHeap, usIndex );
+		}
+	}
+
+	return 1U;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSiftUp( EDFHeap_t * pxHeap, uint16_t usIndex )
+{
+EDFHeapItem_t ** ppxItems = pxHeap->ppxItems;
+EDFHeapItem_t * pxItem = ppxItems[ usIndex ];
+uint16_t usParent;
+
+	while( usIndex > 0U )
+	{
+		usParent = ( usIndex - 1U ) / 2U;
+
+		if( !edfheapIS_EARLIER( pxItem, ppxItems[ usParent ] ) )
+		{
+			break;
+		}
+
+		ppxItems[ usIndex ] = ppxItems[ usParent ];
+		ppxItems[ usIndex ]->usHeapIndex = usIndex;
+		usIndex = usParent;
+	}
+
+	ppxItems[ usIndex ] = pxItem;
+	pxItem->usHeapIndex = usIndex;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSiftDown( EDFHeap_t * pxHeap, uint16_t usIndex )
+{
+EDFHeapItem_t ** ppxItems = pxHeap->ppxItems;
+EDFHeapItem_t * pxItem = ppxItems[ usIndex ];
+uint16_t usCount = pxHeap->usNumberOfItems;
+uint16_t usChild;
+
+	for( ;; )
+	{
+		usChild = ( uint16_t ) ( ( 2U * usIndex ) + 1U );
+
+		if( usChild >= usCount )
+		{
+			break;
+		}
+
+		if( ( ( usChild + 1U ) < usCount ) && edfheapIS_EARLIER( ppxItems[ usChild + 1U ], ppxItems[ usChild ] ) )
+		{
+			usChild++;
+		}
+
+		if( !edfheapIS_EARLIER( ppxItems[ usChild ], pxItem ) )
+		{
+			break;
+		}
+
+		ppxItems[ usIndex ] = ppxItems[ usChild ];
+		ppxItems[ usIndex ]->usHeapIndex = usIndex;
+		usIndex = usChild;
+	}
+
+	ppxItems[ usIndex ] = pxItem;
+	pxItem->usHeapIndex = usIndex;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,68 @@
+#ifndef EDF_HEAP_H
+#define EDF_HEAP_H
+
+#include <stdint.h>
+
+/*
+ * Binary min-heap used as the EDF ready queue when configUSE_EDF_SCHEDULER
+ * is set.  It replaces the deadline sorted xReadyTasksListEDF list:
+ *
+ *   release  (prvAddTaskToReadyList)     -> ucEDFHeapInsert()  O(log n)
+ *   pick next (taskSELECT_HIGHEST_...)   -> pxEDFHeapPeek()    O(1)
+ *   block / suspend (uxListRemove)       -> vEDFHeapRemove()   O(log n)
+ *
+ * Each TCB embeds one EDFHeapItem_t, the same way it embeds xStateListItem,
+ * and pvOwner points back to the TCB.  Deadlines are absolute tick values
+ * and are compared with wrap-around arithmetic, so the queue keeps working
+ * after the tick count overflows.  Tasks with equal deadlines are served in
+ * release order, which matches the behaviour of vListInsert().
+ *
+ * The caller supplies the storage: the kernel needs one pointer for every
+ * task that can be ready at once, the idle task included.
+ *
+ * The module has no kernel dependencies so it can also be built on the
+ * host (see bench/edf_heap_bench.c).
+ */
+
+/************* Type def section ************/
+
+typedef struct xEDF_HEAP_ITEM
+{
+	uint32_t ulDeadline;	/* Absolute deadline in ticks. */
+	uint32_t ulSequence;	/* Release order, breaks ties between equal deadlines. */
+	uint16_t usHeapIndex;	/* Position inside the heap, edfheapNOT_IN_HEAP when not queued. */
+	void * pvOwner;			/* The TCB that owns this item. */
+
+} EDFHeapItem_t;
+
+typedef struct xEDF_HEAP
+{
+	EDFHeapItem_t ** ppxItems;	/* Storage for usCapacity item pointers, supplied by the caller. */
+	uint16_t usNumberOfItems;
+	uint16_t usCapacity;
+	uint32_t ulNextSequence;
+
+} EDFHeap_t;
+
+#define edfheapNOT_IN_HEAP			( ( uint16_t ) 0xffff )
+
+/************ Function declaration section ***********/
+
+extern void vEDFHeapInitialise( EDFHeap_t * pxHeap, EDFHeapItem_t ** ppxStorage, uint16_t usCapacity );
+extern void vEDFHeapInitialiseItem( EDFHeapItem_t * pxItem, void * pvOwner );
+
+/* Returns 1 on success, 0 if the heap is full or the item is already queued. */
+extern uint8_t ucEDFHeapInsert( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem );
+extern void vEDFHeapRemove( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem );
+
+/* Moves a queued item after its deadline changed, or inserts it if it is not
+queued.  Returns 0 only when that insert found the heap full, in which case the
+item is not queued. */
+extern uint8_t ucEDFHeapSetDeadline( EDFHeap_t * pxHeap, EDFHeapItem_t * pxItem, uint32_t ulDeadline );
+
+/* Item with the earliest deadline, NULL when the heap is empty. */
+#define pxEDFHeapPeek( pxHeap )			( ( ( pxHeap )->usNumberOfItems != 0U ) ? ( pxHeap )->ppxItems[ 0 ] : ( EDFHeapItem_t * ) 0 )
+#define usEDFHeapLength( pxHeap )		( ( pxHeap )->usNumberOfItems )
+#define xEDFHeapItemIsQueued( pxItem )	( ( pxItem )->usHeapIndex != edfheapNOT_IN_HEAP )
+
+#endif /* EDF_HEAP_H */
@@ -0,0 +1,81 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Peripheral includes. */
+#include "GPIO_fast.h"
+
+#include "gpio_snapshot.h"
+
+/*-----------------------------------------------------------*/
+
+#if ( configGPIO_SNAPSHOT_TICKS < 1 )
+	#error configGPIO_SNAPSHOT_TICKS must be at least 1
+#endif
+
+/*-----------------------------------------------------------*/
+
+static volatile GpioSnapshot_t xGpioSnapshot = { { 0UL, 0UL }, 0UL };
+
+/* Without vGpioSnapshotInit() the first tick latches. */
+static UBaseType_t uxTicksToLatch = 1;
+
+static void prvLatch( void );
+
+/*-----------------------------------------------------------*/
+
+static void prvLatch( void )
+{
+	uxTicksToLatch = ( UBaseType_t ) configGPIO_SNAPSHOT_TICKS;
+
+	xGpioSnapshot.ulPins[ PORT_0 ] = GPIO_FAST_READ_PORT( PORT_0 );
+	xGpioSnapshot.ulPins[ PORT_1 ] = GPIO_FAST_READ_PORT( PORT_1 );
+	xGpioSnapshot.ulSequence++;
+}
+/*-----------------------------------------------------------*/
+
+void vGpioSnapshotInit( void )
+{
+	taskENTER_CRITICAL();
+	{
+		prvLatch();
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vGpioSnapshotTick( void )
+{
+	if( --uxTicksToLatch == 0U )
+	{
+		prvLatch();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vGpioSnapshotRead( GpioSnapshot_t * pxSnapshot, GpioSnapshot_t * pxChanged )
+{
+GpioSnapshot_t xLatest;
+UBaseType_t x;
+
+	/* The tick interrupt must not latch between the words. */
+	taskENTER_CRITICAL();
+	{
+		xLatest.ulPins[ PORT_0 ] = xGpioSnapshot.ulPins[ PORT_0 ];
+		xLatest.ulPins[ PORT_1 ] = xGpioSnapshot.ulPins[ PORT_1 ];
+		xLatest.ulSequence = xGpioSnapshot.ulSequence;
+	}
+	taskEXIT_CRITICAL();
+
+	if( pxChanged != NULL )
+	{
+		for( x = 0; x < gpioSNAPSHOT_PORTS; x++ )
+		{
+			pxChanged->ulPins[ x ] = xLatest.ulPins[ x ] ^ pxSnapshot->ulPins[ x ];
+		}
+		pxChanged->ulSequence = xLatest.ulSequence - pxSnapshot->ulSequence;
+	}
+
+	*pxSnapshot = xLatest;
+}
+/*-----------------------------------------------------------*/
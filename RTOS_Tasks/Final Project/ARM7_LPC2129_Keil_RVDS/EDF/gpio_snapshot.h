@@ -0,0 +1,61 @@
+#ifndef GPIO_SNAPSHOT_H
+#define GPIO_SNAPSHOT_H
+
+/*
+ * Tick synchronous snapshot of the GPIO inputs.
+ *
+ * vGpioSnapshotTick(), called from the tick hook, latches IOPIN0 and IOPIN1
+ * every configGPIO_SNAPSHOT_TICKS ticks.  Tasks read the latched copy
+ * instead of the pins, so every task sees the same levels for a whole
+ * period, and the levels of one read all come from the same instant.
+ *
+ * Each reader keeps its own GpioSnapshot_t.  vGpioSnapshotRead() updates it
+ * to the latest snapshot and returns which pins changed since that copy was
+ * last updated, so a reader that polls slower than the latch still sees
+ * every level that changed in between, if not every pulse.  An edge is a
+ * changed pin at its new level:
+ *
+ *     vGpioSnapshotRead( &xSeen, &xChanged );
+ *     if( ( xChanged.ulPins[ PORT_0 ] & xSeen.ulPins[ PORT_0 ] & GPIO_PIN_MASK( PIN0 ) ) != 0 )
+ *     {
+ *         rising edge on P0.16
+ *     }
+ *
+ * A reader that should not report the levels found at start up as changes
+ * updates its copy once with pxChanged set to NULL before its loop.
+ */
+
+#include "FreeRTOS.h"
+#include "GPIO.h"
+
+#ifndef configGPIO_SNAPSHOT_TICKS
+	#define configGPIO_SNAPSHOT_TICKS		( 10 )
+#endif
+
+#define gpioSNAPSHOT_PORTS				( 2 )
+
+/************* Type def section ************/
+
+typedef struct
+{
+	uint32_t ulPins[ gpioSNAPSHOT_PORTS ];	/* IOPIN0 and IOPIN1, indexed by portX_t */
+	uint32_t ulSequence;					/* Latches so far, to tell a new snapshot from the last one */
+
+} GpioSnapshot_t;
+
+/************ Function declaration section ***********/
+
+/* Latches both ports now and restarts the period.  Call it after GPIO_init(),
+so that readers never see the empty snapshot of before the first tick. */
+extern void vGpioSnapshotInit( void );
+
+/* Latches both ports once every configGPIO_SNAPSHOT_TICKS calls.  Call it from
+vApplicationTickHook(). */
+extern void vGpioSnapshotTick( void );
+
+/* Copies the latest snapshot to *pxSnapshot.  If pxChanged is not NULL its
+ulPins[] receive the pins that differ from what *pxSnapshot held before, and
+its ulSequence the number of latches in between. */
+extern void vGpioSnapshotRead( GpioSnapshot_t * pxSnapshot, GpioSnapshot_t * pxChanged );
+
+#endif /* GPIO_SNAPSHOT_H */
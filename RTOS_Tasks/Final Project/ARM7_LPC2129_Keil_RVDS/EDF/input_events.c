@@ -0,0 +1,210 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "gpio_snapshot.h"
+#include "input_events.h"
+
+/*-----------------------------------------------------------*/
+
+/* Snapshot periods an input must stay high for a long press. */
+#define inputLONG_PRESS_PERIODS		( pdMS_TO_TICKS( configINPUT_LONG_PRESS_MS ) / ( TickType_t ) configGPIO_SNAPSHOT_TICKS )
+
+/* The hold counters have inputHOLD_BITS planes, and a 0 would never be reached. */
+typedef char InputLongPressFits_t[ ( ( inputLONG_PRESS_PERIODS > 0 ) && ( inputLONG_PRESS_PERIODS < ( 1UL << inputHOLD_BITS ) ) ) ? 1 : -1 ];
+
+/* The 16 pins of each port, P0.16 to P0.31 and P1.16 to P1.31. */
+#define inputPORT_PINS				( 0xffff0000UL )
+
+/*-----------------------------------------------------------*/
+
+struct InputSubscriber
+{
+	TaskHandle_t xTask;
+	uint32_t ulInputs;
+	InputEvents_t xPending;		/* Guarded by a critical section */
+};
+
+static struct InputSubscriber xSubscribers[ configINPUT_MAX_SUBSCRIBERS ];
+static volatile UBaseType_t uxSubscribers = 0;
+
+/* Debouncer state, only touched by the service task.  Bit n of every word
+belongs to input n; ulCount1:ulCount0 and ulHold[] are vertical counters,
+one bit plane per word. */
+static volatile uint32_t ulLevels = 0;
+static uint32_t ulCount0 = 0;
+static uint32_t ulCount1 = 0;
+static uint32_t ulHold[ inputHOLD_BITS ];
+static uint32_t ulLongReported = 0;
+
+static void prvInputTask( void * pvParameters );
+static uint32_t prvPackInputs( const GpioSnapshot_t * pxSnapshot );
+static void prvDebounce( uint32_t ulSample, InputEvents_t * pxEvents );
+static void prvPublish( const InputEvents_t * pxEvents );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xInputEventsStart( UBaseType_t uxTaskPriority )
+{
+	return xTaskCreate( prvInputTask, "Inputs", configMINIMAL_STACK_SIZE, NULL, uxTaskPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+InputSubscriberHandle_t xInputEventsSubscribe( uint32_t ulInputs )
+{
+InputSubscriberHandle_t xSubscriber = NULL;
+
+	taskENTER_CRITICAL();
+	{
+		if( uxSubscribers < ( UBaseType_t ) configINPUT_MAX_SUBSCRIBERS )
+		{
+			xSubscriber = &xSubscribers[ uxSubscribers ];
+			xSubscriber->xTask = xTaskGetCurrentTaskHandle();
+			xSubscriber->ulInputs = ulInputs;
+			xSubscriber->xPending.ulRising = 0;
+			xSubscriber->xPending.ulFalling = 0;
+			xSubscriber->xPending.ulLongPress = 0;
+			uxSubscribers++;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xSubscriber;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xInputEventsWait( InputSubscriberHandle_t xSubscriber, InputEvents_t * pxEvents, TickType_t xTicksToWait )
+{
+	/* Events published after the notification was taken are collected here
+	as well, and their notification makes the next wait return at once. */
+	( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+
+	taskENTER_CRITICAL();
+	{
+		*pxEvents = xSubscriber->xPending;
+		xSubscriber->xPending.ulRising = 0;
+		xSubscriber->xPending.ulFalling = 0;
+		xSubscriber->xPending.ulLongPress = 0;
+	}
+	taskEXIT_CRITICAL();
+
+	return ( ( pxEvents->ulRising | pxEvents->ulFalling | pxEvents->ulLongPress ) != 0UL ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulInputEventsGetLevels( void )
+{
+	return ulLevels;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInputTask( void * pvParameters )
+{
+GpioSnapshot_t xSnapshot, xChanged;
+InputEvents_t xEvents;
+TickType_t xLastWakeTime;
+UBaseType_t x;
+
+	( void ) pvParameters;
+
+	/* The levels found at start up are accepted as they are, not reported. */
+	vGpioSnapshotRead( &xSnapshot, NULL );
+	ulLevels = prvPackInputs( &xSnapshot );
+	for( x = 0; x < inputHOLD_BITS; x++ )
+	{
+		ulHold[ x ] = 0;
+	}
+
+	xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, ( TickType_t ) configGPIO_SNAPSHOT_TICKS );
+
+		/* Woken before the latch of this period, the next wake catches up. */
+		vGpioSnapshotRead( &xSnapshot, &xChanged );
+		if( xChanged.ulSequence == 0UL )
+		{
+			continue;
+		}
+
+		prvDebounce( prvPackInputs( &xSnapshot ), &xEvents );
+
+		if( ( xEvents.ulRising | xEvents.ulFalling | xEvents.ulLongPress ) != 0UL )
+		{
+			prvPublish( &xEvents );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPackInputs( const GpioSnapshot_t * pxSnapshot )
+{
+	return ( ( pxSnapshot->ulPins[ PORT_0 ] & inputPORT_PINS ) >> 16 ) | ( pxSnapshot->ulPins[ PORT_1 ] & inputPORT_PINS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDebounce( uint32_t ulSample, InputEvents_t * pxEvents )
+{
+uint32_t ulDelta, ulToggle, ulCarry, ulNextCarry, ulReached, ulNewLevels;
+UBaseType_t x;
+
+	/* Count the inputs that disagree with their accepted level, clear the
+	others.  The counter steps 0, 1, 2, 3 and wraps to 0 on the fourth
+	disagreeing sample, which flips the level. */
+	ulDelta = ulSample ^ ulLevels;
+	ulCount1 = ( ulCount1 ^ ulCount0 ) & ulDelta;
+	ulCount0 = ~ulCount0 & ulDelta;
+	ulToggle = ulDelta & ~( ulCount0 | ulCount1 );
+	ulNewLevels = ulLevels ^ ulToggle;
+	ulLevels = ulNewLevels;
+
+	pxEvents->ulRising = ulToggle & ulNewLevels;
+	pxEvents->ulFalling = ulToggle & ~ulNewLevels;
+
+	/* Add one to the hold counter of every high input not yet reported, and
+	compare each with inputLONG_PRESS_PERIODS on the way.  Low inputs start
+	again from 0. */
+	ulCarry = ulNewLevels & ~ulLongReported;
+	ulReached = ulCarry;
+	for( x = 0; x < inputHOLD_BITS; x++ )
+	{
+		ulHold[ x ] &= ulNewLevels;
+		ulNextCarry = ulHold[ x ] & ulCarry;
+		ulHold[ x ] ^= ulCarry;
+		ulCarry = ulNextCarry;
+
+		ulReached &= ( ( ( inputLONG_PRESS_PERIODS >> x ) & 1U ) != 0U ) ? ulHold[ x ] : ~ulHold[ x ];
+	}
+
+	pxEvents->ulLongPress = ulReached;
+	ulLongReported = ( ulLongReported | ulReached ) & ulNewLevels;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPublish( const InputEvents_t * pxEvents )
+{
+struct InputSubscriber * pxSubscriber;
+uint32_t ulInputs;
+UBaseType_t x;
+
+	for( x = 0; x < uxSubscribers; x++ )
+	{
+		pxSubscriber = &xSubscribers[ x ];
+		ulInputs = pxSubscriber->ulInputs;
+
+		if( ( ( pxEvents->ulRising | pxEvents->ulFalling | pxEvents->ulLongPress ) & ulInputs ) != 0UL )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxSubscriber->xPending.ulRising |= pxEvents->ulRising & ulInputs;
+				pxSubscriber->xPending.ulFalling |= pxEvents->ulFalling & ulInputs;
+				pxSubscriber->xPending.ulLongPress |= pxEvents->ulLongPress & ulInputs;
+			}
+			taskEXIT_CRITICAL();
+
+			xTaskNotifyGive( pxSubscriber->xTask );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
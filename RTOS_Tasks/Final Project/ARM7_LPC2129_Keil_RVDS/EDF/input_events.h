@@ -0,0 +1,81 @@
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+/*
+ * Input events: one service task debounces the 32 GPIO inputs and wakes the
+ * tasks that wait for them.
+ *
+ * P0.16 to P0.31 and P1.16 to P1.31 are packed into one 32 bit word, input
+ * 0 to 15 for port 0 and 16 to 31 for port 1 (inputBIT()).  Once per
+ * snapshot period the task takes the word from the tick synchronous
+ * snapshot (gpio_snapshot.h) and runs every input through the same bitwise
+ * operations, so all 32 are debounced at the cost of one:
+ *
+ *  - a 2 bit vertical counter per input counts the samples that disagree
+ *    with the accepted level and restarts on any that agrees.  The accepted
+ *    level flips on the fourth disagreeing sample in a row
+ *    (inputDEBOUNCE_SAMPLES), which is a rising or a falling event.
+ *  - an inputHOLD_BITS bit vertical counter per input counts the periods an
+ *    input has stayed high.  Reaching configINPUT_LONG_PRESS_MS is a long
+ *    press event, once per press.
+ *
+ * A task subscribes to a mask of inputs, then blocks in xInputEventsWait().
+ * The service accumulates the events of those inputs for it and gives its
+ * task notification, so a subscriber runs only when something happened and
+ * gets every event since its last wait, even if it was slow to run.  The
+ * notification value is the subscriber's own; it must not use it for
+ * anything else.
+ *
+ * vGpioSnapshotTick() must be called from the tick hook and
+ * vGpioSnapshotInit() after GPIO_init().
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "GPIO.h"
+
+#ifndef configINPUT_MAX_SUBSCRIBERS
+	#define configINPUT_MAX_SUBSCRIBERS		( 4 )
+#endif
+
+#ifndef configINPUT_LONG_PRESS_MS
+	#define configINPUT_LONG_PRESS_MS		( 1000 )
+#endif
+
+#define inputDEBOUNCE_SAMPLES				( 4 )
+#define inputHOLD_BITS						( 8 )
+
+/* Bit of a pin in the input word and in the event masks. */
+#define inputBIT( xPort, xPin )				( ( uint32_t ) 1UL << ( ( ( uint32_t ) ( xPort ) * 16UL ) + ( ( uint32_t ) ( xPin ) - ( uint32_t ) PIN0 ) ) )
+
+/************* Type def section ************/
+
+typedef struct
+{
+	uint32_t ulRising;		/* Inputs that went high */
+	uint32_t ulFalling;		/* Inputs that went low */
+	uint32_t ulLongPress;	/* Inputs high for configINPUT_LONG_PRESS_MS */
+
+} InputEvents_t;
+
+typedef struct InputSubscriber * InputSubscriberHandle_t;
+
+/************ Function declaration section ***********/
+
+/* Creates the service task.  Call once before vTaskStartScheduler().  Returns
+pdPASS, or pdFAIL when there is not enough heap. */
+extern BaseType_t xInputEventsStart( UBaseType_t uxTaskPriority );
+
+/* Subscribes the calling task to the events of the inputs in ulInputs, a mask
+of inputBIT()s.  Returns the handle for xInputEventsWait(), or NULL when all
+configINPUT_MAX_SUBSCRIBERS slots are taken. */
+extern InputSubscriberHandle_t xInputEventsSubscribe( uint32_t ulInputs );
+
+/* Waits up to xTicksToWait for events, then moves all that are pending to
+*pxEvents.  Returns pdTRUE when there was at least one. */
+extern BaseType_t xInputEventsWait( InputSubscriberHandle_t xSubscriber, InputEvents_t * pxEvents, TickType_t xTicksToWait );
+
+/* The debounced levels of the 32 inputs. */
+extern uint32_t ulInputEventsGetLevels( void );
+
+#endif /* INPUT_EVENTS_H */
@@ -0,0 +1,19 @@
+/*
+ * Format table of the binary log (log_ring.h).
+ *
+ * One logFORMAT( name, "format" ) line per message.  The names become the
+ * format IDs, numbered from 0 in the order below, and the strings never reach
+ * the firmware image: Tools/log_decode reads this file to turn the IDs back
+ * into text.  Only append new lines, or decode old captures with the table
+ * they were made with.
+ *
+ * Conversions are printf style on 32 bit arguments: %d %i %u %x %X %o %c and
+ * %%, with flags and width.  At most three per format, and at most 63 formats
+ * (IDs 0 to 62, see log_ring.h).
+ * No include guard: log_ring.h expands it to build the ID list.
+ */
+
+logFORMAT( logEDGE_RISING,		"Rising edge %u" )
+logFORMAT( logEDGE_FALLING,		"Falling edge %u" )
+logFORMAT( logHELLO,			"Hello" )
+logFORMAT( logLONG_PRESS,		"Long press" )
@@ -0,0 +1,180 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lpc21xx.h"
+
+/* Peripheral includes. */
+#include "serial.h"
+
+#include "log_ring.h"
+
+#if ( configUSE_LOG_RING == 1 )
+
+/*-----------------------------------------------------------*/
+
+#if ( ( configLOG_RING_LENGTH & ( configLOG_RING_LENGTH - 1 ) ) != 0 )
+	#error configLOG_RING_LENGTH must be a power of two
+#endif
+
+#ifndef configLOG_DRAIN_BYTES
+	#define configLOG_DRAIN_BYTES		( 64 )
+#endif
+
+#define logRING_MASK					( ( uint32_t ) configLOG_RING_LENGTH - 1UL )
+
+/* A 32 bit value takes at most 5 varint bytes. */
+#define logMAX_VARINT_BYTES				( 5U )
+#define logMAX_RECORD_BYTES				( 1U + ( ( 1U + logMAX_ARGS ) * logMAX_VARINT_BYTES ) )
+#define logSYNC_BYTES					( 9U )
+
+#if ( configLOG_DRAIN_BYTES < ( logSYNC_BYTES + logMAX_RECORD_BYTES ) )
+	#error configLOG_DRAIN_BYTES cannot hold a sync and a record
+#endif
+
+/*-----------------------------------------------------------*/
+
+static LogRecord_t xLogRing[ configLOG_RING_LENGTH ];
+static volatile uint32_t ulLogRingHead = 0;
+static volatile uint32_t ulLogRingTail = 0;
+static volatile uint32_t ulLogRingDropped = 0;
+
+/* Encoder state, only touched by vLogRingDrain().  A chunk is encoded on
+copies of it, which are kept only when the driver has taken the chunk. */
+static uint32_t ulLastTimestamp = 0;
+static uint32_t ulSinceSync = configLOG_SYNC_INTERVAL;
+static uint16_t usLastDropped = 0;
+
+/* Static because the idle task stack is far too small for it. */
+static uint8_t ucDrainBuffer[ configLOG_DRAIN_BYTES ];
+
+static uint32_t prvPutVarint( uint8_t * pucOut, uint32_t ulValue );
+
+/*-----------------------------------------------------------*/
+
+void vLogRingRecordFromISR( LogFormat_t xFormat, uint8_t ucArgs, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2 )
+{
+const uint32_t ulHead = ulLogRingHead;
+LogRecord_t * pxRecord;
+
+	if( ( ulHead - ulLogRingTail ) < ( uint32_t ) configLOG_RING_LENGTH )
+	{
+		pxRecord = &xLogRing[ ulHead & logRING_MASK ];
+		pxRecord->ulTimestamp = T1TC;
+		pxRecord->ucFormat = ( uint8_t ) xFormat;
+		pxRecord->ucArgs = ucArgs;
+		pxRecord->ulArgs[ 0 ] = ulArg0;
+		pxRecord->ulArgs[ 1 ] = ulArg1;
+		pxRecord->ulArgs[ 2 ] = ulArg2;
+		ulLogRingHead = ulHead + 1UL;
+	}
+	else
+	{
+		ulLogRingDropped++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vLogRingRecord( LogFormat_t xFormat, uint8_t ucArgs, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2 )
+{
+	taskENTER_CRITICAL();
+	{
+		vLogRingRecordFromISR( xFormat, ucArgs, ulArg0, ulArg1, ulArg2 );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vLogRingDrain( void )
+{
+uint32_t ulTail = ulLogRingTail;
+const uint32_t ulHead = ulLogRingHead;
+uint32_t ulTimestamp = ulLastTimestamp;
+uint32_t ulSince = ulSinceSync;
+uint16_t usDropped = usLastDropped;
+uint32_t ulBytes = 0, x;
+const LogRecord_t * pxRecord;
+
+	/* Only this function moves the tail, so the records between tail and
+	head can be read without stopping the producers. */
+	while( ulTail != ulHead )
+	{
+		pxRecord = &xLogRing[ ulTail & logRING_MASK ];
+
+		if( ( ulSince >= configLOG_SYNC_INTERVAL ) || ( usDropped != ( uint16_t ) ulLogRingDropped ) )
+		{
+			if( ( ulBytes + logSYNC_BYTES + logMAX_RECORD_BYTES ) > configLOG_DRAIN_BYTES )
+			{
+				break;
+			}
+
+			/* The first record after a sync is sent with a delta of 0. */
+			ulTimestamp = pxRecord->ulTimestamp;
+			usDropped = ( uint16_t ) ulLogRingDropped;
+
+			ucDrainBuffer[ ulBytes++ ] = logSYNC_HEADER;
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) 'L';
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) 'G';
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ulTimestamp;
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ( ulTimestamp >> 8 );
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ( ulTimestamp >> 16 );
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ( ulTimestamp >> 24 );
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) usDropped;
+			ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ( usDropped >> 8 );
+			ulSince = 0;
+		}
+		else if( ( ulBytes + logMAX_RECORD_BYTES ) > configLOG_DRAIN_BYTES )
+		{
+			break;
+		}
+
+		ucDrainBuffer[ ulBytes++ ] = ( uint8_t ) ( ( pxRecord->ucFormat << 2 ) | pxRecord->ucArgs );
+		ulBytes += prvPutVarint( &ucDrainBuffer[ ulBytes ], pxRecord->ulTimestamp - ulTimestamp );
+		for( x = 0; x < pxRecord->ucArgs; x++ )
+		{
+			ulBytes += prvPutVarint( &ucDrainBuffer[ ulBytes ], pxRecord->ulArgs[ x ] );
+		}
+
+		ulTimestamp = pxRecord->ulTimestamp;
+		ulSince++;
+		ulTail++;
+	}
+
+	if( ulBytes == 0U )
+	{
+		return;
+	}
+
+	/* The driver refuses the chunk when its transmit ring cannot take all of
+	it; the records then stay in the ring and are encoded again next time. */
+	if( vSerialPutString( ( const signed char * ) ucDrainBuffer, ( unsigned short ) ulBytes ) == pdTRUE )
+	{
+		ulLastTimestamp = ulTimestamp;
+		ulSinceSync = ulSince;
+		usLastDropped = usDropped;
+		ulLogRingTail = ulTail;
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulLogRingGetDropped( void )
+{
+	return ulLogRingDropped;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPutVarint( uint8_t * pucOut, uint32_t ulValue )
+{
+uint32_t ulBytes = 0;
+
+	while( ulValue >= 0x80UL )
+	{
+		pucOut[ ulBytes++ ] = ( uint8_t ) ( ulValue | 0x80UL );
+		ulValue >>= 7;
+	}
+	pucOut[ ulBytes++ ] = ( uint8_t ) ulValue;
+
+	return ulBytes;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_LOG_RING */
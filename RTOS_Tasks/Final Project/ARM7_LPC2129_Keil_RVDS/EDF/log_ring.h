@@ -0,0 +1,110 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+/*
+ * Deferred binary logging.
+ *
+ * logPRINT0() to logPRINT3() record a format ID from log_formats.h, the T1TC
+ * timestamp and up to three 32 bit arguments into a power of two ring.  No
+ * text is formatted or stored on the target.  The idle hook encodes pending
+ * records and sends them over UART1 with vLogRingDrain(), and
+ * Tools/log_decode prints them as text using the same log_formats.h.
+ *
+ * On the wire a record is one header byte, ( format << 2 ) | argument count,
+ * then the T1TC counts since the previous record and each argument, all as
+ * base 128 varints (low 7 bits first, bit 7 set on every byte but the last).
+ * A line such as "Hello" therefore takes 3 bytes at 100 ms intervals.
+ *
+ * Header 0xff is a sync record: 'L', 'G', the absolute T1TC the next delta
+ * refers to and the low 16 bits of the drop counter, little endian.  One is
+ * sent before the first record, every configLOG_SYNC_INTERVAL records and
+ * whenever records have been dropped, so the decoder can start anywhere in
+ * a capture and report the gaps.
+ *
+ * When the ring is full new records are dropped and counted.  With
+ * configUSE_LOG_RING set to 0 the logging calls compile to nothing.
+ */
+
+#include "FreeRTOS.h"
+
+#ifndef configUSE_LOG_RING
+	#define configUSE_LOG_RING			0
+#endif
+
+#ifndef configLOG_RING_LENGTH
+	#define configLOG_RING_LENGTH		( 32 )
+#endif
+
+#ifndef configLOG_SYNC_INTERVAL
+	#define configLOG_SYNC_INTERVAL		( 32 )
+#endif
+
+#define logMAX_ARGS					( 3 )
+#define logSYNC_HEADER				( ( uint8_t ) 0xff )
+
+/************* Type def section ************/
+
+typedef enum
+{
+	#define logFORMAT( xName, pcFormat )	xName,
+	#include "log_formats.h"
+	#undef logFORMAT
+	logFORMAT_COUNT
+
+} LogFormat_t;
+
+/* The header byte keeps 6 bits for the format, and 0xff is the sync record,
+so the IDs stop at 62: at most 63 formats. */
+typedef char LogFormatTableFits_t[ ( logFORMAT_COUNT <= 63 ) ? 1 : -1 ];
+
+typedef struct
+{
+	uint32_t ulTimestamp;	/* T1TC */
+	uint8_t ucFormat;
+	uint8_t ucArgs;
+	uint32_t ulArgs[ logMAX_ARGS ];
+
+} LogRecord_t;
+
+#if ( configUSE_LOG_RING == 1 )
+
+	#define logPRINT0( xFormat )					vLogRingRecord( ( xFormat ), 0, 0, 0, 0 )
+	#define logPRINT1( xFormat, a )					vLogRingRecord( ( xFormat ), 1, ( uint32_t ) ( a ), 0, 0 )
+	#define logPRINT2( xFormat, a, b )				vLogRingRecord( ( xFormat ), 2, ( uint32_t ) ( a ), ( uint32_t ) ( b ), 0 )
+	#define logPRINT3( xFormat, a, b, c )			vLogRingRecord( ( xFormat ), 3, ( uint32_t ) ( a ), ( uint32_t ) ( b ), ( uint32_t ) ( c ) )
+
+	#define logPRINT0_FROM_ISR( xFormat )			vLogRingRecordFromISR( ( xFormat ), 0, 0, 0, 0 )
+	#define logPRINT1_FROM_ISR( xFormat, a )		vLogRingRecordFromISR( ( xFormat ), 1, ( uint32_t ) ( a ), 0, 0 )
+	#define logPRINT2_FROM_ISR( xFormat, a, b )		vLogRingRecordFromISR( ( xFormat ), 2, ( uint32_t ) ( a ), ( uint32_t ) ( b ), 0 )
+	#define logPRINT3_FROM_ISR( xFormat, a, b, c )	vLogRingRecordFromISR( ( xFormat ), 3, ( uint32_t ) ( a ), ( uint32_t ) ( b ), ( uint32_t ) ( c ) )
+
+	/************ Function declaration section ***********/
+
+	/* Appends one record from task context.  Use the logPRINTn() macros. */
+	extern void vLogRingRecord( LogFormat_t xFormat, uint8_t ucArgs, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2 );
+
+	/* Same, for ISRs and callers that already run with IRQ disabled. */
+	extern void vLogRingRecordFromISR( LogFormat_t xFormat, uint8_t ucArgs, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2 );
+
+	/* Sends pending records over UART1 if the port has room.  Called from the idle hook. */
+	extern void vLogRingDrain( void );
+
+	/* Records dropped because the ring was full. */
+	extern uint32_t ulLogRingGetDropped( void );
+
+#else
+
+	#define logPRINT0( xFormat )
+	#define logPRINT1( xFormat, a )
+	#define logPRINT2( xFormat, a, b )
+	#define logPRINT3( xFormat, a, b, c )
+	#define logPRINT0_FROM_ISR( xFormat )
+	#define logPRINT1_FROM_ISR( xFormat, a )
+	#define logPRINT2_FROM_ISR( xFormat, a, b )
+	#define logPRINT3_FROM_ISR( xFormat, a, b, c )
+	#define vLogRingDrain()
+	#define ulLogRingGetDropped()				( 0UL )
+
+#endif /* configUSE_LOG_RING */
+
+#endif /* LOG_RING_H */
@@ -0,0 +1,190 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "lpc21xx.h"
+#include "GPIO.h"
+#include "task_monitor.h"
+
+/*-----------------------------------------------------------*/
+
+TaskMonitor_t xTaskMonitor[ monitorNUMBER_OF_SLOTS ];
+TaskExecution_t xTaskExecution[ monitorNUMBER_OF_SLOTS ];
+uint32_t ulTaskExecutionCurrentSlot = monitorUNTAGGED_SLOT;
+
+static BaseType_t xIdleTagged = pdFALSE;
+
+/* Retags xTask from uxOldSlot to uxNewSlot.  Call in a critical section. */
+static void prvMoveTask( TaskHandle_t xTask, UBaseType_t uxOldSlot, UBaseType_t uxNewSlot );
+
+/* Lateness for the trace ring, which only has 16 bits for it. */
+static uint16_t prvSaturateToInt16( int32_t lValue );
+
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskMonitorRegister( TaskHandle_t xTask, TickType_t xRelativeDeadline )
+{
+UBaseType_t uxSlot, uxFound = monitorUNTAGGED_SLOT;
+TaskMonitor_t * pxMonitor;
+
+	vTaskSuspendAll();
+	{
+		for( uxSlot = 1; uxSlot < monitorIDLE_SLOT; uxSlot++ )
+		{
+			if( xTaskMonitor[ uxSlot ].xHandle == NULL )
+			{
+				uxFound = uxSlot;
+				break;
+			}
+		}
+
+		if( uxFound != monitorUNTAGGED_SLOT )
+		{
+			pxMonitor = &xTaskMonitor[ uxFound ];
+			pxMonitor->xHandle = xTask;
+			pxMonitor->xRelativeDeadline = xRelativeDeadline;
+			pxMonitor->ulJobs = 0;
+			pxMonitor->ulDeadlineMisses = 0;
+			pxMonitor->ulConsecutiveMisses = 0;
+			pxMonitor->xMaxLateness = 0;
+
+			xTaskExecution[ uxFound ].ulTotalExecution = 0;
+			xTaskExecution[ uxFound ].ulProbeMask = ( uint32_t ) 1UL << ( configTASK_PROBE_FIRST_PIN + uxFound - 1U );
+
+			vTaskSetApplicationTaskTag( xTask, ( TaskHookFunction_t ) uxFound );
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return uxFound;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskMonitorUnregister( TaskHandle_t xTask )
+{
+UBaseType_t uxSlot = ( UBaseType_t ) xTaskGetApplicationTaskTag( xTask );
+
+	if( ( uxSlot != monitorUNTAGGED_SLOT ) && ( uxSlot < monitorIDLE_SLOT ) )
+	{
+		taskENTER_CRITICAL();
+		{
+			prvMoveTask( xTask, uxSlot, monitorUNTAGGED_SLOT );
+			xTaskMonitor[ uxSlot ].xHandle = NULL;
+			xTaskExecution[ uxSlot ].ulProbeMask = 0;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTaskMonitorIdleHook( void )
+{
+	if( xIdleTagged == pdFALSE )
+	{
+		taskENTER_CRITICAL();
+		{
+			xTaskExecution[ monitorIDLE_SLOT ].ulTotalExecution = 0;
+			xTaskExecution[ monitorIDLE_SLOT ].ulProbeMask = 0;
+			prvMoveTask( NULL, monitorUNTAGGED_SLOT, monitorIDLE_SLOT );
+		}
+		taskEXIT_CRITICAL();
+
+		xIdleTagged = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTaskMonitorSetProbe( TaskHandle_t xTask, uint32_t ulProbeMask )
+{
+UBaseType_t uxSlot = ( UBaseType_t ) xTaskGetApplicationTaskTag( xTask );
+
+	if( ( uxSlot != monitorUNTAGGED_SLOT ) && ( uxSlot < monitorNUMBER_OF_SLOTS ) )
+	{
+		xTaskExecution[ uxSlot ].ulProbeMask = ulProbeMask;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTaskDelayUntilChecked( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement )
+{
+UBaseType_t uxSlot = ( UBaseType_t ) xTaskGetApplicationTaskTag( NULL );
+TaskMonitor_t * pxMonitor;
+TickType_t xLateness;
+
+	if( ( uxSlot != monitorUNTAGGED_SLOT ) && ( uxSlot < monitorNUMBER_OF_SLOTS ) )
+	{
+		pxMonitor = &xTaskMonitor[ uxSlot ];
+
+		/* *pxPreviousWakeTime is the release time of the job that is
+		finishing now.  The job ends somewhere inside the current tick, so
+		once the tick count has reached release + deadline it is late, even
+		when only by a fraction of a tick.  The lateness is rounded up to
+		whole ticks, never reported low.  The subtraction is done in
+		TickType_t so that it stays correct when the tick count wraps. */
+		xLateness = ( ( xTaskGetTickCount() - *pxPreviousWakeTime ) + 1U ) - pxMonitor->xRelativeDeadline;
+		pxMonitor->ulJobs++;
+
+		vTraceRingRecord( ringEVENT_DEADLINE, prvSaturateToInt16( ( int32_t ) xLateness ) );
+
+		if( ( xLateness != 0U ) && ( xLateness < ( ( TickType_t ) portMAX_DELAY >> 1 ) ) )
+		{
+			pxMonitor->ulDeadlineMisses++;
+			pxMonitor->ulConsecutiveMisses++;
+
+			if( xLateness > pxMonitor->xMaxLateness )
+			{
+				pxMonitor->xMaxLateness = xLateness;
+			}
+
+			#if ( configUSE_DEADLINE_MISS_HOOK == 1 )
+			{
+				vApplicationDeadlineMissHook( pxMonitor->xHandle, xLateness );
+			}
+			#endif
+		}
+		else
+		{
+			pxMonitor->ulConsecutiveMisses = 0;
+		}
+	}
+
+	vTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMoveTask( TaskHandle_t xTask, UBaseType_t uxOldSlot, UBaseType_t uxNewSlot )
+{
+uint32_t ulNow;
+
+	/* A task retagging itself is running in the old slot: close its run
+	there and carry on in the new one from now, as a switch would, or its
+	next switch out would charge the new slot from a stale start time. */
+	if( ulTaskExecutionCurrentSlot == ( uint32_t ) uxOldSlot )
+	{
+		ulNow = T1TC;
+		xTaskExecution[ uxOldSlot ].ulTotalExecution += ( ulNow - xTaskExecution[ uxOldSlot ].ulSwitchInTime );
+		xTaskExecution[ uxNewSlot ].ulSwitchInTime = ulNow;
+		ulTaskExecutionCurrentSlot = ( uint32_t ) uxNewSlot;
+	}
+
+	/* The switch out clears the new slot's pins, not these. */
+	IOCLR0 = xTaskExecution[ uxOldSlot ].ulProbeMask;
+
+	vTaskSetApplicationTaskTag( xTask, ( TaskHookFunction_t ) uxNewSlot );
+}
+/*-----------------------------------------------------------*/
+
+static uint16_t prvSaturateToInt16( int32_t lValue )
+{
+	if( lValue > 32767L )
+	{
+		lValue = 32767L;
+	}
+	else if( lValue < -32768L )
+	{
+		lValue = -32768L;
+	}
+
+	return ( uint16_t ) ( int16_t ) lValue;
+}
+/*-----------------------------------------------------------*/
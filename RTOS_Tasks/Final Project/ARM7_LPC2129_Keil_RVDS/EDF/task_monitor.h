@@ -0,0 +1,96 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+/*
+ * Per-task runtime monitor for periodic tasks.
+ *
+ * Each monitored task owns one slot of xTaskMonitor[] and xTaskExecution[]
+ * and its application task tag is set to the slot number, so the kernel
+ * hooks can find the slot with a single array index.  Slot 0 collects every
+ * untagged task.  The idle task has a slot of its own, monitorIDLE_SLOT,
+ * which it takes on the first call of vTaskMonitorIdleHook(), so that its
+ * time is not mixed with the time of the tasks that do work.
+ *
+ * A job is released when vTaskDelayUntilChecked() wakes the task and
+ * completes at the next call.  If it completes after release + deadline
+ * the miss counters are updated and vApplicationDeadlineMissHook() is
+ * called from the task that missed.  Completion is only known to the tick,
+ * so a job ending in the tick after its deadline counts as late and
+ * lateness is rounded up to whole ticks.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_trace.h"
+
+#ifndef configEDF_MAX_PERIODIC_TASKS
+	#define configEDF_MAX_PERIODIC_TASKS		( 8 )
+#endif
+
+#ifndef configUSE_DEADLINE_MISS_HOOK
+	#define configUSE_DEADLINE_MISS_HOOK		0
+#endif
+
+/* Slot n drives IO0 pin ( configTASK_PROBE_FIRST_PIN + n - 1 ) while it runs. */
+#ifndef configTASK_PROBE_FIRST_PIN
+	#define configTASK_PROBE_FIRST_PIN			PIN3
+#endif
+
+#define monitorUNTAGGED_SLOT		( ( UBaseType_t ) 0 )
+#define monitorIDLE_SLOT			( ( UBaseType_t ) ( configEDF_MAX_PERIODIC_TASKS + 1 ) )
+#define monitorNUMBER_OF_SLOTS		( configEDF_MAX_PERIODIC_TASKS + 2 )
+
+/************* Type def section ************/
+
+typedef struct
+{
+	TaskHandle_t xHandle;				/* NULL while the slot is free. */
+	TickType_t xRelativeDeadline;
+
+	uint32_t ulJobs;					/* Completed jobs. */
+	uint32_t ulDeadlineMisses;
+	uint32_t ulConsecutiveMisses;
+	TickType_t xMaxLateness;			/* Ticks past the deadline, rounded up, worst job so far. */
+
+} TaskMonitor_t;
+
+extern TaskMonitor_t xTaskMonitor[ monitorNUMBER_OF_SLOTS ];
+extern TaskExecution_t xTaskExecution[ monitorNUMBER_OF_SLOTS ];
+
+/************ Function declaration section ***********/
+
+/*
+ * Gives xTask a monitor slot and sets its task tag to the slot number.
+ * The slot's execution time is cleared and its probe pin assigned.
+ * xRelativeDeadline is in ticks.  Returns the slot, or monitorUNTAGGED_SLOT
+ * when all slots are in use.
+ */
+extern UBaseType_t uxTaskMonitorRegister( TaskHandle_t xTask, TickType_t xRelativeDeadline );
+
+/*
+ * Frees the slot of xTask, sets its tag back to monitorUNTAGGED_SLOT and
+ * drives its probe pins low.  May be called by the task itself, xTask NULL
+ * or its own handle: the run in progress is charged to the old slot up to
+ * the call and to slot 0 after it.
+ */
+extern void vTaskMonitorUnregister( TaskHandle_t xTask );
+
+/* Moves the idle task to monitorIDLE_SLOT on its first call, then returns at
+once.  Call it from vApplicationIdleHook(). */
+extern void vTaskMonitorIdleHook( void );
+
+/* Replaces the probe pins of a registered task, from its next switch in. */
+extern void vTaskMonitorSetProbe( TaskHandle_t xTask, uint32_t ulProbeMask );
+
+/*
+ * Drop-in replacement for vTaskDelayUntil() in periodic tasks.  Checks the
+ * job that is finishing against its deadline before delaying.
+ */
+extern void vTaskDelayUntilChecked( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement );
+
+#if ( configUSE_DEADLINE_MISS_HOOK == 1 )
+	/* Provided by the application.  Runs in the context of the late task. */
+	extern void vApplicationDeadlineMissHook( TaskHandle_t xTask, TickType_t xLateness );
+#endif
+
+#endif /* TASK_MONITOR_H */
@@ -0,0 +1,39 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "edf_admission.h"
+#include "task_monitor.h"
+#include "task_table.h"
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskTableCreate( const PeriodicTaskConfig_t * pxTable, UBaseType_t uxLength, TaskHandle_t * pxHandles )
+{
+const PeriodicTaskConfig_t * pxRow;
+BaseType_t xReturn = pdPASS;
+UBaseType_t x;
+
+	for( x = 0; ( x < uxLength ) && ( xReturn == pdPASS ); x++ )
+	{
+		pxRow = &pxTable[ x ];
+
+		xReturn = xTaskPeriodicCreateChecked( pxRow->pxTaskCode,
+											  pxRow->pcName,
+											  pxRow->usStackDepth,
+											  ( void * ) pxRow,
+											  pxRow->uxPriority,
+											  &pxHandles[ x ],
+											  pxRow->xPeriod,
+											  pxRow->xDeadline,
+											  pxRow->ulWcetUs );
+
+		if( ( xReturn == pdPASS ) && ( pxRow->ulProbeMask != 0U ) )
+		{
+			vTaskMonitorSetProbe( pxHandles[ x ], pxRow->ulProbeMask );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
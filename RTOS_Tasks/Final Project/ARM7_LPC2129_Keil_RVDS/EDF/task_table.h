@@ -0,0 +1,43 @@
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+/*
+ * Periodic task sets described by a constant table.
+ *
+ * The table is normally generated from the SimSo model of the task set by
+ * Tools/simso_tasks, so the firmware runs exactly the periods, deadlines
+ * and execution times that were analysed.  Each row is passed to its task
+ * as pvParameters, which lets one job body serve every task: it burns
+ * ulWcetUs with vBurnCpuMicroseconds() and waits for xPeriod with
+ * vTaskDelayUntilChecked().
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/************* Type def section ************/
+
+typedef struct
+{
+	TaskFunction_t pxTaskCode;
+	const char * pcName;
+	unsigned short usStackDepth;
+	UBaseType_t uxPriority;
+	TickType_t xPeriod;
+	TickType_t xDeadline;		/* Relative, 0 for the period. */
+	uint32_t ulWcetUs;			/* Execution time budget of one job. */
+	uint32_t ulProbeMask;		/* IO0 bits high while the task runs, 0 keeps the task monitor's choice. */
+
+} PeriodicTaskConfig_t;
+
+/************ Function declaration section ***********/
+
+/*
+ * Creates every task of the table with xTaskPeriodicCreateChecked() and
+ * applies its probe mask.  pxHandles receives uxLength handles.  Stops at
+ * the first task that cannot be created and returns its error; the tasks
+ * created before it are kept.
+ */
+extern BaseType_t xTaskTableCreate( const PeriodicTaskConfig_t * pxTable, UBaseType_t uxLength, TaskHandle_t * pxHandles );
+
+#endif /* TASK_TABLE_H */
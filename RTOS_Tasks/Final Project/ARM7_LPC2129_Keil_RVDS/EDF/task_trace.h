@@ -0,0 +1,40 @@
+#ifndef TASK_TRACE_H
+#define TASK_TRACE_H
+
+/*
+ * Execution time accounting used by the traceTASK_SWITCHED_IN/OUT macros in
+ * FreeRTOSConfig.h.
+ *
+ * The table is indexed by the application task tag, which the task monitor
+ * sets to the task's slot number (see task_monitor.h), so a context switch
+ * costs one array index, one Timer1 read and one IOSET0/IOCLR0 store for
+ * any number of tasks.  Untagged tasks share slot 0 whose probe mask is 0;
+ * the idle task has its own slot, see task_monitor.h.
+ *
+ * This header is included from FreeRTOSConfig.h, so it must not depend on
+ * any FreeRTOS type.
+ */
+
+#include <stdint.h>
+
+/************* Type def section ************/
+
+typedef struct
+{
+	uint32_t ulProbeMask;		/* IO0 bit driven high while the task runs, 0 for none. */
+	uint32_t ulSwitchInTime;	/* T1TC when the task was last switched in. */
+	uint32_t ulTotalExecution;	/* Accumulated run time in Timer1 counts. */
+
+} TaskExecution_t;
+
+extern TaskExecution_t xTaskExecution[];
+
+/* Slot of the task that is running, maintained by traceTASK_SWITCHED_IN. */
+extern uint32_t ulTaskExecutionCurrentSlot;
+
+/* Sliding window load snapshots (cpu_load.c), taken from traceTASK_SWITCHED_OUT
+once T1TC passes ulCPULoadNextSnapshot. */
+extern uint32_t ulCPULoadNextSnapshot;
+extern void vCPULoadSnapshot( uint32_t ulNow );
+
+#endif /* TASK_TRACE_H */
@@ -0,0 +1,84 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lpc21xx.h"
+
+/* Peripheral includes. */
+#include "serial.h"
+
+#include "task_trace.h"
+#include "trace_ring.h"
+
+#if ( configUSE_TRACE_RING == 1 )
+
+/*-----------------------------------------------------------*/
+
+#if ( ( configTRACE_RING_LENGTH & ( configTRACE_RING_LENGTH - 1 ) ) != 0 )
+	#error configTRACE_RING_LENGTH must be a power of two
+#endif
+
+#ifndef configTRACE_DRAIN_CHUNK
+	#define configTRACE_DRAIN_CHUNK		( 15 )
+#endif
+
+/*-----------------------------------------------------------*/
+
+TraceEvent_t xTraceRing[ configTRACE_RING_LENGTH ];
+volatile uint32_t ulTraceRingHead = 0;
+volatile uint32_t ulTraceRingTail = 0;
+volatile uint32_t ulTraceRingDropped = 0;
+
+/* One sync record plus the events of one chunk.  Static because the idle
+task stack is far too small for it. */
+static TraceEvent_t xDrainBuffer[ configTRACE_DRAIN_CHUNK + 1 ];
+
+/*-----------------------------------------------------------*/
+
+void vTraceRingRecord( uint8_t ucEvent, uint16_t usArg )
+{
+	taskENTER_CRITICAL();
+	{
+		traceRING_RECORD_FROM_ISR( ucEvent, ulTaskExecutionCurrentSlot, usArg, T1TC );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRingDrain( void )
+{
+uint32_t ulTail = ulTraceRingTail;
+uint32_t ulCount = ulTraceRingHead - ulTail;
+uint32_t x;
+
+	if( ulCount == 0U )
+	{
+		return;
+	}
+
+	if( ulCount > configTRACE_DRAIN_CHUNK )
+	{
+		ulCount = configTRACE_DRAIN_CHUNK;
+	}
+
+	/* Only this function moves the tail, so the events between tail and
+	head can be copied without stopping the producers. */
+	for( x = 0; x < ulCount; x++ )
+	{
+		xDrainBuffer[ x + 1U ] = xTraceRing[ ( ulTail + x ) & ( ( uint32_t ) configTRACE_RING_LENGTH - 1UL ) ];
+	}
+
+	xDrainBuffer[ 0 ].ulTimestamp = ringSYNC_MAGIC;
+	xDrainBuffer[ 0 ].ucEvent = ringEVENT_SYNC;
+	xDrainBuffer[ 0 ].ucSlot = ( uint8_t ) ulCount;
+	xDrainBuffer[ 0 ].usArg = ( uint16_t ) ulTraceRingDropped;
+
+	/* The driver refuses the string when its transmit ring cannot take all
+	of it; the events then stay in the ring for the next attempt. */
+	if( vSerialPutString( ( const signed char * ) xDrainBuffer, ( unsigned short ) ( ( ulCount + 1U ) * sizeof( TraceEvent_t ) ) ) == pdTRUE )
+	{
+		ulTraceRingTail = ulTail + ulCount;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TRACE_RING */
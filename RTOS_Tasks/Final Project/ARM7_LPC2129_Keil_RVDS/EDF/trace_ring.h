@@ -0,0 +1,96 @@
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+/*
+ * Binary scheduling trace.
+ *
+ * Kernel trace macros and drivers append 8 byte events, timestamped with
+ * T1TC, to a power of two ring.  The idle hook drains the ring over UART1
+ * with vTraceRingDrain(), and Tools/trace_export converts the captured
+ * stream into Chrome trace JSON, which also opens in the Perfetto UI.
+ *
+ * On the wire every chunk starts with a sync record (ringEVENT_SYNC, the
+ * ringSYNC_MAGIC timestamp, the number of events that follow in ucSlot and
+ * the low 16 bits of the drop counter in usArg), followed by the events
+ * exactly as they are stored below, little endian.
+ *
+ * When the ring is full new events are dropped and counted, so the host
+ * can tell where the trace has gaps.  Like task_trace.h, this header is
+ * included from FreeRTOSConfig.h and must not use FreeRTOS types.  It is
+ * included after configUSE_TRACE_RING is defined; with the option off all
+ * recording compiles to nothing.
+ */
+
+#include <stdint.h>
+
+/* Event codes. */
+#define ringEVENT_SWITCH_IN			( ( uint8_t ) 1 )	/* ucSlot switched in. */
+#define ringEVENT_SWITCH_OUT		( ( uint8_t ) 2 )	/* ucSlot switched out. */
+#define ringEVENT_READY				( ( uint8_t ) 3 )	/* ucSlot released or unblocked. */
+#define ringEVENT_DEADLINE			( ( uint8_t ) 4 )	/* ucSlot finished a job, usArg = lateness in ticks rounded up (int16_t, > 0 is a miss). */
+#define ringEVENT_ISR_ENTER			( ( uint8_t ) 5 )	/* ucSlot = VIC channel. */
+#define ringEVENT_ISR_EXIT			( ( uint8_t ) 6 )	/* ucSlot = VIC channel. */
+#define ringEVENT_QUEUE_BLOCK_RX	( ( uint8_t ) 7 )	/* ucSlot blocked receiving from queue usArg (low address bits). */
+#define ringEVENT_QUEUE_BLOCK_TX	( ( uint8_t ) 8 )	/* ucSlot blocked sending to queue usArg (low address bits). */
+#define ringEVENT_SYNC				( ( uint8_t ) 0xff )
+
+#define ringSYNC_MAGIC				( ( uint32_t ) 0x31435254UL )	/* "TRC1" */
+
+/************* Type def section ************/
+
+typedef struct
+{
+	uint32_t ulTimestamp;	/* T1TC */
+	uint8_t ucEvent;
+	uint8_t ucSlot;			/* Task monitor slot, or VIC channel for ISR events. */
+	uint16_t usArg;
+
+} TraceEvent_t;
+
+#if ( configUSE_TRACE_RING == 1 )
+
+	extern TraceEvent_t xTraceRing[];
+	extern volatile uint32_t ulTraceRingHead;
+	extern volatile uint32_t ulTraceRingTail;
+	extern volatile uint32_t ulTraceRingDropped;
+
+	/*
+	 * Appends one event.  Only for callers that already run with IRQ disabled:
+	 * the context switch hooks, kernel critical sections and ISRs.  Tasks use
+	 * vTraceRingRecord().
+	 */
+	#define traceRING_RECORD_FROM_ISR( ucEvt, ucSlt, usA, ulTime )	do \
+		{ \
+			const uint32_t ulRingHead = ulTraceRingHead; \
+			if( ( ulRingHead - ulTraceRingTail ) < ( uint32_t ) configTRACE_RING_LENGTH ) \
+			{ \
+				TraceEvent_t * const pxRingEvent = &xTraceRing[ ulRingHead & ( ( uint32_t ) configTRACE_RING_LENGTH - 1UL ) ]; \
+				pxRingEvent->ulTimestamp = ( ulTime ); \
+				pxRingEvent->ucEvent = ( ucEvt ); \
+				pxRingEvent->ucSlot = ( uint8_t ) ( ucSlt ); \
+				pxRingEvent->usArg = ( uint16_t ) ( usA ); \
+				ulTraceRingHead = ulRingHead + 1UL; \
+			} \
+			else \
+			{ \
+				ulTraceRingDropped++; \
+			} \
+		} while( 0 )
+
+	/************ Function declaration section ***********/
+
+	/* Appends one event for the running task from task context. */
+	extern void vTraceRingRecord( uint8_t ucEvent, uint16_t usArg );
+
+	/* Sends pending events over UART1 if the port is free.  Called from the idle hook. */
+	extern void vTraceRingDrain( void );
+
+#else
+
+	#define traceRING_RECORD_FROM_ISR( ucEvt, ucSlt, usA, ulTime )
+	#define vTraceRingRecord( ucEvent, usArg )
+	#define vTraceRingDrain()
+
+#endif /* configUSE_TRACE_RING */
+
+#endif /* TRACE_RING_H */
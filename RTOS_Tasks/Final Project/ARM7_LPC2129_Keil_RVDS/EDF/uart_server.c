@@ -0,0 +1,165 @@
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "serial.h"
+#include "uart_server.h"
+
+/*-----------------------------------------------------------*/
+
+/* Segments per burst and bursts queued in the driver at once.  Together they
+must fit the driver's caller buffer entries. */
+#define uartserverMAX_SEGMENTS			( 4 )
+#define uartserverBURSTS_IN_FLIGHT		( 2 )
+
+#if defined( configSERIAL_TX_BUFFERS ) && ( ( uartserverMAX_SEGMENTS * uartserverBURSTS_IN_FLIGHT ) > configSERIAL_TX_BUFFERS )
+	#error configSERIAL_TX_BUFFERS is too small for the UART server
+#endif
+
+/* Retry period when the driver's entries are taken by another writer. */
+#define uartserverRETRY_TICKS			( ( TickType_t ) 1 )
+
+/*-----------------------------------------------------------*/
+
+/* One SerialSegment_t is what a producer queues; the server passes it on. */
+static QueueHandle_t xRequestQueues[ configUART_SERVER_PRIORITIES ];
+static TaskHandle_t xServerTask = NULL;
+static volatile uint32_t ulDropped = 0;
+
+/* A burst the driver had no room for, kept until it can be queued. */
+static SerialSegment_t xHeldBurst[ uartserverMAX_SEGMENTS ];
+static UBaseType_t uxHeldSegments = 0;
+
+static void prvServerTask( void * pvParameters );
+static UBaseType_t prvCollectBurst( SerialSegment_t * pxBurst );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartServerStart( UBaseType_t uxTaskPriority )
+{
+UBaseType_t x;
+
+	for( x = 0; x < configUART_SERVER_PRIORITIES; x++ )
+	{
+		xRequestQueues[ x ] = xQueueCreate( configUART_SERVER_QUEUE_LENGTH, sizeof( SerialSegment_t ) );
+		if( xRequestQueues[ x ] == NULL )
+		{
+			return pdFAIL;
+		}
+	}
+
+	return xTaskCreate( prvServerTask, "UartSrv", configMINIMAL_STACK_SIZE, NULL, uxTaskPriority, &xServerTask );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartServerSend( const void * pvData, unsigned short usLength, UBaseType_t uxPriority )
+{
+SerialSegment_t xRequest;
+
+	configASSERT( xServerTask != NULL );
+
+	/* The driver skips empty segments, so a burst of nothing but empty
+	requests would never be accepted. */
+	if( ( pvData == NULL ) || ( usLength == 0U ) )
+	{
+		return pdFALSE;
+	}
+
+	if( uxPriority >= configUART_SERVER_PRIORITIES )
+	{
+		uxPriority = configUART_SERVER_PRIORITIES - 1U;
+	}
+
+	xRequest.pvData = pvData;
+	xRequest.usLength = usLength;
+
+	if( xQueueSend( xRequestQueues[ uxPriority ], &xRequest, 0 ) != pdPASS )
+	{
+		ulDropped++;
+		return pdFALSE;
+	}
+
+	/* eNoAction leaves the count of finished bursts alone but still wakes
+	the server, or makes its next wait return at once. */
+	( void ) xTaskNotify( xServerTask, 0, eNoAction );
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulUartServerGetDropped( void )
+{
+	return ulDropped;
+}
+/*-----------------------------------------------------------*/
+
+static void prvServerTask( void * pvParameters )
+{
+UBaseType_t uxInFlight = 0;
+uint32_t ulFinished;
+TickType_t xWait = portMAX_DELAY;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Woken by a new request, or by the driver's vTaskNotifyGiveFromISR
+		for each burst that has left the FIFO. */
+		ulFinished = 0;
+		( void ) xTaskNotifyWait( 0, ~( ( uint32_t ) 0 ), &ulFinished, xWait );
+		uxInFlight -= ( ulFinished < uxInFlight ) ? ( UBaseType_t ) ulFinished : uxInFlight;
+		xWait = portMAX_DELAY;
+
+		while( uxInFlight < uartserverBURSTS_IN_FLIGHT )
+		{
+			if( uxHeldSegments == 0U )
+			{
+				uxHeldSegments = prvCollectBurst( xHeldBurst );
+				if( uxHeldSegments == 0U )
+				{
+					break;
+				}
+			}
+
+			if( xSerialSendv( xHeldBurst, uxHeldSegments, xServerTask ) != pdTRUE )
+			{
+				xWait = uartserverRETRY_TICKS;
+				break;
+			}
+
+			uxHeldSegments = 0;
+			uxInFlight++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvCollectBurst( SerialSegment_t * pxBurst )
+{
+UBaseType_t uxSegments = 0, uxPriority = configUART_SERVER_PRIORITIES;
+uint32_t ulBytes = 0;
+
+	/* Most urgent queue first; a request is never split, so a burst can end
+	up longer than configUART_SERVER_BURST_BYTES by one request. */
+	while( ( uxPriority > 0U ) && ( uxSegments < uartserverMAX_SEGMENTS ) && ( ulBytes < configUART_SERVER_BURST_BYTES ) )
+	{
+		if( xQueueReceive( xRequestQueues[ uxPriority - 1U ], &pxBurst[ uxSegments ], 0 ) == pdPASS )
+		{
+			/* xUartServerSend refuses empty requests; dropping any that get
+			here anyway keeps a burst from being retried for ever. */
+			if( ( pxBurst[ uxSegments ].pvData != NULL ) && ( pxBurst[ uxSegments ].usLength > 0U ) )
+			{
+				ulBytes += pxBurst[ uxSegments ].usLength;
+				uxSegments++;
+			}
+		}
+		else
+		{
+			uxPriority--;
+		}
+	}
+
+	return uxSegments;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,58 @@
+#ifndef UART_SERVER_H
+#define UART_SERVER_H
+
+/*
+ * UART server: one task owns UART1 transmission for the tasks that share it.
+ *
+ * Producers post a request (a pointer and a length) to one of several
+ * priority queues and return at once; they never wait for the port or for
+ * each other.  The server takes the most urgent requests first and hands
+ * them to the driver as one scatter-gather transmission (xSerialSendv()) of
+ * about one TX FIFO, so the bytes go out zero-copy and each burst costs one
+ * THRE interrupt per 16 bytes.  At most two bursts are queued in the driver
+ * at a time, so a request posted at a higher priority overtakes everything
+ * except those two bursts.
+ *
+ * The bytes are sent straight from the producer's memory, which must stay
+ * unchanged until they have gone: string literals and constant tables are
+ * the intended use.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef configUART_SERVER_PRIORITIES
+	#define configUART_SERVER_PRIORITIES		( 2 )
+#endif
+
+/* Enough for one task's ten line burst in the UART demo. */
+#ifndef configUART_SERVER_QUEUE_LENGTH
+	#define configUART_SERVER_QUEUE_LENGTH		( 10 )
+#endif
+
+/* A burst is closed once it holds this many bytes, one TX FIFO by default. */
+#ifndef configUART_SERVER_BURST_BYTES
+	#define configUART_SERVER_BURST_BYTES		( 16 )
+#endif
+
+/* Request priorities for the default configUART_SERVER_PRIORITIES. */
+#define uartserverPRIORITY_LOW		( 0 )
+#define uartserverPRIORITY_HIGH		( 1 )
+
+/************ Function declaration section ***********/
+
+/* Creates the request queues and the server task.  Call once before
+vTaskStartScheduler(), after xSerialPortInitMinimal().  Returns pdPASS, or
+pdFAIL when there is not enough heap. */
+extern BaseType_t xUartServerStart( UBaseType_t uxTaskPriority );
+
+/* Queues usLength bytes at pvData at request priority uxPriority, 0 being the
+lowest.  Never blocks: returns pdFALSE, and counts a drop, when the queue of
+that priority is full.  An empty request (pvData NULL or usLength 0) is
+refused with pdFALSE and not counted. */
+extern BaseType_t xUartServerSend( const void * pvData, unsigned short usLength, UBaseType_t uxPriority );
+
+/* Requests refused because their queue was full. */
+extern uint32_t ulUartServerGetDropped( void );
+
+#endif /* UART_SERVER_H */
@@ -31,6 +31,7 @@
 #include "lpc21xx.h"
 #include "portmacro.h"
 #include "GPIO.h"
+#include "task_trace.h"
 
 
 
@@ -57,13 +58,35 @@
 #define configTICK_RATE_HZ			( ( TickType_t ) 1000 ) /* 100 MICRO */
 #define configMAX_PRIORITIES		( 4 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 90 )
-#define configTOTAL_HEAP_SIZE		( ( size_t ) 13 * 1024 )
+#define configTOTAL_HEAP_SIZE		( ( size_t ) 10 * 1024 )
 #define configMAX_TASK_NAME_LEN		( 8 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		0
 #define configIDLE_SHOULD_YIELD		1
 #define configUSE_TIME_SLICING    0 /*Time slicing */
 #define configUSE_EDF_SCHEDULER   1 /*EDF scheduler */
+#define configUSE_EDF_ADMISSION_CONTROL	1 /* Schedulability test in xTaskPeriodicCreateChecked */
+#define configEDF_MAX_PERIODIC_TASKS	( 8 )
+#define configUSE_DEADLINE_MISS_HOOK	1 /* vApplicationDeadlineMissHook, see EDF/task_monitor.h */
+#define configTRACE_TIMER_PRESCALE	( 1000UL ) /* T1PR, Timer1 is the trace and load time base */
+#define configTRACE_TIMER_HZ		( configCPU_CLOCK_HZ / ( configTRACE_TIMER_PRESCALE + 1UL ) ) /* VPBDIV = 1 */
+#define configLOAD_WINDOWS_MS		{ 100, 1000, 10000 } /* CPU load windows, see EDF/cpu_load.h */
+#define configLOAD_NUMBER_OF_WINDOWS	( 3 )
+#define configLOAD_WINDOW_SUBDIVISIONS	( 4 )
+#define configUSE_TRACE_RING		1 /* Binary scheduling trace over UART1, see EDF/trace_ring.h */
+#define configTRACE_RING_LENGTH		( 64 ) /* events, power of two, 8 bytes each */
+#define configUSE_LOG_RING			1 /* Binary logging over UART1, see EDF/log_ring.h and Tools/log_decode */
+#define configLOG_RING_LENGTH		( 32 ) /* records, power of two, 20 bytes each */
+#define configSERIAL_TX_BUFFER_SIZE	( 256 ) /* bytes, power of two, UART1 transmit ring in serial.c */
+#define configSERIAL_TX_SINGLE_WRITER	0 /* 1 when only one task writes to UART1, drops the writer lock */
+#define configSERIAL_TX_BUFFERS		( 8 ) /* power of two, caller buffers and segments queued by xSerialSendBuffer/xSerialSendv */
+#define configSERIAL_RX_BUFFER_SIZE	( 128 ) /* bytes, power of two, UART1 receive ring in serial.c */
+#define configUART_SERVER_PRIORITIES	( 2 ) /* request priorities of the UART server, see EDF/uart_server.h */
+#define configUART_SERVER_QUEUE_LENGTH	( 10 ) /* requests waiting per priority */
+#define configUART_SERVER_BURST_BYTES	( 16 ) /* bytes handed to the driver at once, one TX FIFO */
+#define configGPIO_SNAPSHOT_TICKS	( 10 ) /* IOPIN0/IOPIN1 latched every 10 ms from the tick hook, see EDF/gpio_snapshot.h */
+#define configINPUT_MAX_SUBSCRIBERS	( 4 ) /* tasks waiting for debounced input events, see EDF/input_events.h */
+#define configINPUT_LONG_PRESS_MS	( 1000 ) /* input held high this long is a long press */
 #define configUSE_APPLICATION_TASK_TAG	1 /* Task Tag */
 
 
@@ -84,51 +107,51 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetCurrentTaskHandle	1
 
 
-/* Task tags */
+/* Task tags: set to the task monitor slot, see EDF/task_monitor.h */
 
+#define configTASK_PROBE_FIRST_PIN	PIN3 /* slot 1 -> PIN3, slot 2 -> PIN4, ... */
 
-/* Tasks Time */
+/* Trace Hooks: O(1) per switch, indexed by task tag (EDF/task_trace.h) */
 
-extern TaskTimingParameters task1Time,task2Time;
-
-/* Trace Hooks */
+#include "trace_ring.h"
 
 #define traceTASK_SWITCHED_IN()				 do \
 																			 {\
-																				 /* task 1 */ \
-																				 if((int)pxCurrentTCB->pxTaskTag == 1)\
-																				 {\
-																					 GPIO_write(PORT_0,PIN3,PIN_IS_HIGH);\
-																					 task1Time.startTime =T1TC;\
-																				 }\
-																				 /* task 2 */ \
-																				 else if((int)pxCurrentTCB->pxTaskTag == 2)\
-																				 {\
-																					 GPIO_write(PORT_0,PIN4,PIN_IS_HIGH);\
-																					 task2Time.startTime =T1TC;\
-																				 }\
+																				 TaskExecution_t * const pxExecution = &xTaskExecution[ ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag ];\
+																				 const uint32_t ulNow = T1TC;\
+																				 IOSET0 = pxExecution->ulProbeMask;\
+																				 ulTaskExecutionCurrentSlot = ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag;\
+																				 pxExecution->ulSwitchInTime = ulNow;\
+																				 traceRING_RECORD_FROM_ISR( ringEVENT_SWITCH_IN, ulTaskExecutionCurrentSlot, 0, ulNow );\
 																   		 }\
 																			 while(0)
 
 #define traceTASK_SWITCHED_OUT()      do \
 																			 {\
-																				 /* task 1 */ \
-																				 if((int)pxCurrentTCB->pxTaskTag == 1)\
+																				 TaskExecution_t * const pxExecution = &xTaskExecution[ ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag ];\
+																				 const uint32_t ulNow = T1TC;\
+																				 IOCLR0 = pxExecution->ulProbeMask;\
+																				 pxExecution->ulTotalExecution += ( ulNow - pxExecution->ulSwitchInTime );\
+																				 traceRING_RECORD_FROM_ISR( ringEVENT_SWITCH_OUT, ( uint32_t ) ( uintptr_t ) pxCurrentTCB->pxTaskTag, 0, ulNow );\
+																				 if( ( int32_t ) ( ulNow - ulCPULoadNextSnapshot ) >= 0 )\
 																				 {\
-																					 GPIO_write(PORT_0,PIN3,PIN_IS_LOW);\
-																					 task1Time.endTime =T1TC;\
-																					 task1Time.TotalExecution +=((task1Time.endTime) -(task1Time.startTime));\
-																				 }\
-																				 /* task 2 */ \
-																				 else if((int)pxCurrentTCB->pxTaskTag == 2)\
-																				 {\
-																					 GPIO_write(PORT_0,PIN4,PIN_IS_LOW);\
-																					 task2Time.endTime =T1TC;\
-																					 task2Time.TotalExecution +=((task2Time.endTime) -(task2Time.startTime));\
+																					 vCPULoadSnapshot( ulNow );\
 																				 }\
 																   		 }\
 																			 while(0)
+
+/* Released by the kernel or unblocked, always inside a critical section or ISR */
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )		traceRING_RECORD_FROM_ISR( ringEVENT_READY, ( uint32_t ) ( uintptr_t ) ( pxTCB )->pxTaskTag, 0, T1TC )
+
+/* Blocking on a queue, called from task context with interrupts enabled */
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )	vTraceRingRecord( ringEVENT_QUEUE_BLOCK_RX, ( uint16_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )		vTraceRingRecord( ringEVENT_QUEUE_BLOCK_TX, ( uint16_t ) ( uintptr_t ) ( pxQueue ) )
+
+/* UART1 interrupt, VIC channel 7 (Starter_Files_V0/source/serial.c) */
+#define traceUART_ISR_ENTER()		traceRING_RECORD_FROM_ISR( ringEVENT_ISR_ENTER, 7, 0, T1TC )
+#define traceUART_ISR_EXIT()		traceRING_RECORD_FROM_ISR( ringEVENT_ISR_EXIT, 7, 0, T1TC )
 																			
 #endif /* FREERTOS_CONFIG_H */
@@ -3,6 +3,8 @@
 #ifndef GPIO_H_
 #define GPIO_H_
 
+#include <stdint.h>
+
 /************* Type def section ************/
 
 /* Port data type */
@@ -49,6 +51,11 @@ typedef enum
 
 }pinState_t;
 
+/* Bit of pinNum in the IOxxx registers.  OR several of them together for the
+masks of GPIO_writeMask() and GPIO_writePort(); with constant pins the mask is
+a constant as well. */
+#define GPIO_PIN_MASK(pinNum)		((uint32_t)1UL << (pinNum))
+
 
 /************ Function declaration section ***********/
 
@@ -56,6 +63,17 @@ extern void GPIO_init(void);
 extern pinState_t GPIO_read(portX_t PortName, pinX_t pinNum);
 extern void GPIO_write(portX_t PortName, pinX_t PinNum, pinState_t pinState);
 
+/* All pins of a port with one IOPIN load, so that they agree with each other.
+Test them with GPIO_PIN_MASK(). */
+extern uint32_t GPIO_readPort(portX_t PortName);
+
+/* Drives the pins in setMask high and those in clearMask low, with one IOSET
+and one IOCLR store.  A pin in both masks ends up low. */
+extern void GPIO_writeMask(portX_t PortName, uint32_t setMask, uint32_t clearMask);
+
+/* Drives each pin in mask to its bit in value, with the same two stores. */
+extern void GPIO_writePort(portX_t PortName, uint32_t mask, uint32_t value);
+
 
 
 #endif /* DIO_MCAL_INC_DIO_H_ */
@@ -1,8 +1,55 @@
-
-
 #ifndef GPIO_CFG_H_
 #define GPIO_CFG_H_
 
+/************* Configuration section ************/
+
+/* One ENTRY(arg, port, pin, direction, initial level) per configured pin.
+Outputs are driven to their level before they turn into outputs; inputs take
+PIN_IS_LOW.  A pin may only appear once, GPIO_cfg.c rejects duplicates and
+inputs given a high level at compile time. */
+#define GPIO_CFG_PIN_TABLE(ENTRY, arg) \
+	ENTRY(arg, PORT_0, PIN0, INPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN1, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN2, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN3, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN4, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN5, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN6, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN7, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN8, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN9, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN10, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN11, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN13, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN14, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_0, PIN15, OUTPUT, PIN_IS_LOW) \
+	\
+	ENTRY(arg, PORT_1, PIN0, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN1, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN2, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN3, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN4, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN5, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN6, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN7, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN8, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN9, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN10, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN11, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN13, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN14, OUTPUT, PIN_IS_LOW) \
+	ENTRY(arg, PORT_1, PIN15, OUTPUT, PIN_IS_LOW)
+
+/* The table reduced to one mask per port and purpose, all constants */
+#define GPIO_CFG_USED_BIT(wantPort, port, pin, dir, level)		| (((port) == (wantPort)) ? GPIO_PIN_MASK(pin) : 0UL)
+#define GPIO_CFG_OUTPUT_BIT(wantPort, port, pin, dir, level)	| ((((port) == (wantPort)) && ((dir) == OUTPUT)) ? GPIO_PIN_MASK(pin) : 0UL)
+#define GPIO_CFG_HIGH_BIT(wantPort, port, pin, dir, level)		| ((((port) == (wantPort)) && ((dir) == OUTPUT) && ((level) == PIN_IS_HIGH)) ? GPIO_PIN_MASK(pin) : 0UL)
+
+#define GPIO_CFG_USED_MASK(port)		(0UL GPIO_CFG_PIN_TABLE(GPIO_CFG_USED_BIT, port))
+#define GPIO_CFG_OUTPUT_MASK(port)		(0UL GPIO_CFG_PIN_TABLE(GPIO_CFG_OUTPUT_BIT, port))
+#define GPIO_CFG_HIGH_MASK(port)		(0UL GPIO_CFG_PIN_TABLE(GPIO_CFG_HIGH_BIT, port))
+#define GPIO_CFG_LOW_MASK(port)			(GPIO_CFG_OUTPUT_MASK(port) & ~GPIO_CFG_HIGH_MASK(port))
+
 /************* Type def section ************/
 
 typedef struct
@@ -10,12 +57,15 @@ typedef struct
 	portX_t Port;
 	pinX_t Pin;
 	pinDir_t Direction;
+	pinState_t InitialState;
 	
 }PinConfig_t;
 
 
-extern PinConfig_t PinConfig_array[];
-extern uint16_t PinConfig_array_size;
+/* The table as data, for code that wants to list the pins.  GPIO_init() only
+uses the masks above. */
+extern const PinConfig_t PinConfig_array[];
+extern const uint16_t PinConfig_array_size;
 
 
 #endif 
@@ -0,0 +1,58 @@
+#ifndef GPIO_FAST_H_
+#define GPIO_FAST_H_
+
+/*
+ * Inline GPIO access for the hot paths: the tick hook, the idle hook and the
+ * trace hooks in FreeRTOSConfig.h.
+ *
+ * The macros take the same arguments as GPIO_write() and GPIO_read(), but
+ * the port must be spelled PORT_0 or PORT_1 and the pin must be a constant.
+ * The port name is pasted into the register name and the pin becomes a
+ * constant mask, so every access is a single load or store of a fixed
+ * register, whatever the optimisation level.  Anything else, a port held in
+ * a variable for instance, keeps using the GPIO.h functions.
+ *
+ * With GPIO_FAST_ACCESS set to 0 the macros call the GPIO.h functions, to
+ * compare the two or to break on every access in the debugger.
+ */
+
+#include "GPIO.h"
+#include "lpc21xx.h"
+
+#ifndef GPIO_FAST_ACCESS
+	#define GPIO_FAST_ACCESS	1
+#endif
+
+#if (GPIO_FAST_ACCESS == 1)
+
+/* Registers by portX_t name, for token pasting */
+#define GPIO_IOPIN_PORT_0		IOPIN0
+#define GPIO_IOPIN_PORT_1		IOPIN1
+#define GPIO_IOSET_PORT_0		IOSET0
+#define GPIO_IOSET_PORT_1		IOSET1
+#define GPIO_IOCLR_PORT_0		IOCLR0
+#define GPIO_IOCLR_PORT_1		IOCLR1
+
+#define GPIO_FAST_SET(port, pinNum)					(GPIO_IOSET_##port = GPIO_PIN_MASK(pinNum))
+#define GPIO_FAST_CLR(port, pinNum)					(GPIO_IOCLR_##port = GPIO_PIN_MASK(pinNum))
+#define GPIO_FAST_READ(port, pinNum)				((pinState_t)((GPIO_IOPIN_##port >> (pinNum)) & 1UL))
+#define GPIO_FAST_READ_PORT(port)					((uint32_t)GPIO_IOPIN_##port)
+#define GPIO_FAST_WRITE_MASK(port, setMask, clearMask)	do { GPIO_IOSET_##port = (setMask); GPIO_IOCLR_##port = (clearMask); } while(0)
+
+#else
+
+#define GPIO_FAST_SET(port, pinNum)					GPIO_write((port), (pinNum), PIN_IS_HIGH)
+#define GPIO_FAST_CLR(port, pinNum)					GPIO_write((port), (pinNum), PIN_IS_LOW)
+#define GPIO_FAST_READ(port, pinNum)				GPIO_read((port), (pinNum))
+#define GPIO_FAST_READ_PORT(port)					GPIO_readPort(port)
+#define GPIO_FAST_WRITE_MASK(port, setMask, clearMask)	GPIO_writeMask((port), (setMask), (clearMask))
+
+#endif /* GPIO_FAST_ACCESS */
+
+/* PIN_IS_LOW clears the pin and any other value sets it, where GPIO_write()
+leaves the pin alone for values other than PIN_IS_LOW and PIN_IS_HIGH.  A
+constant pinState leaves only one of the two stores. */
+#define GPIO_FAST_WRITE(port, pinNum, pinState)		do { if((pinState) == PIN_IS_LOW) { GPIO_FAST_CLR(port, pinNum); } else { GPIO_FAST_SET(port, pinNum); } } while(0)
+
+
+#endif /* GPIO_FAST_H_ */
@@ -86,9 +86,70 @@ typedef enum
 	ser115200
 } eBaud;
 
+/* One piece of a transmission queued by xSerialSendv(). */
+typedef struct
+{
+	const void * pvData;
+	unsigned short usLength;
+} SerialSegment_t;
+
 void xSerialPortInitMinimal( unsigned long ulWantedBaud);
+
+/* Queues the whole string for UART1, or returns pdFALSE and queues nothing
+when the transmit ring does not have room for all of it. */
 signed portBASE_TYPE vSerialPutString(const signed char * const pcString, unsigned short usStringLength);
+
+/* Queues as much of pcData as the transmit ring has room for and returns the
+number of bytes taken.  Never blocks. */
+unsigned short usSerialWrite( const signed char * const pcData, unsigned short usLength );
+
+/* Queues usLength bytes at pvData to be sent straight from there, after
+everything queued before.  The buffer must stay untouched until xNotifyTask,
+if not NULL, gets a notification (vTaskNotifyGiveFromISR) once the bytes have
+left the FIFO.  Returns pdFALSE when configSERIAL_TX_BUFFERS buffers are
+already queued. */
+signed portBASE_TYPE xSerialSendBuffer( const void * const pvData, unsigned short usLength, TaskHandle_t xNotifyTask );
+
+/* Like xSerialSendBuffer() for uxCount segments sent back to back as one
+transmission: nothing any other writer queues can come between them.  Each
+non-empty segment takes one of the configSERIAL_TX_BUFFERS entries, and
+xNotifyTask is notified once, after the last one.  Returns pdFALSE, queueing
+nothing, when there are not enough free entries or no bytes at all. */
+signed portBASE_TYPE xSerialSendv( const SerialSegment_t * const pxSegments, UBaseType_t uxCount, TaskHandle_t xNotifyTask );
+
+/* Most bytes ever waiting in the transmit ring, to size configSERIAL_TX_BUFFER_SIZE. */
+unsigned short usSerialGetTxHighWaterMark( void );
+
+/* Free bytes in the transmit ring.  Only writers shrink it, so a writer that
+holds off the others (vTaskSuspendAll) can count on at least this much. */
+unsigned short usSerialGetTxFree( void );
+
 signed portBASE_TYPE xSerialGetChar(signed char *pcRxedChar);
+
+/* Copies up to usMax received bytes out of the receive ring and returns how
+many there were.  Never blocks. */
+unsigned short usSerialRead( signed char * const pcBuffer, unsigned short usMax );
+
+/* Selects the task that gets a notification (vTaskNotifyGiveFromISR) when a
+burst of received bytes ends, or earlier when the ring is half full.  NULL
+stops the notifications. */
+void vSerialSetRxNotifyTask( TaskHandle_t xTask );
+
+/* Selects the task that gets one notification (vTaskNotifyGiveFromISR) per
+0x00 byte received, i.e. per complete zero delimited frame.  NULL stops them.
+While it is set a frame that does not fit in the receive ring is dropped
+whole, so the task must read whole frames only, with usSerialReadFrame().
+Use a different task from vSerialSetRxNotifyTask(), both count on the same
+notification value. */
+void vSerialSetRxFrameTask( TaskHandle_t xTask );
+
+/* Copies received bytes up to and including the next 0x00, or up to usMax
+bytes, whichever comes first, and returns how many it copied.  Never blocks. */
+unsigned short usSerialReadFrame( signed char * const pcBuffer, unsigned short usMax );
+
+/* Received bytes lost because the FIFO or the receive ring was full. */
+unsigned long ulSerialGetRxOverruns( void );
+
 void xSerialPutChar(signed char cOutChar);
 
 #endif
@@ -9,51 +9,21 @@
 
 void GPIO_init(void)
 {
-	int i;
-	
-	for(i = 0; i < PinConfig_array_size;i++)
-	{
-		switch(PinConfig_array[i].Port)
-		{
-			case PORT_0:
-				if(INPUT == PinConfig_array[i].Direction)
-				{
-					CLR_BIT(IODIR0, PinConfig_array[i].Pin);
-				}
-				else if (OUTPUT == PinConfig_array[i].Direction)
-				{
-					SET_BIT(IODIR0, PinConfig_array[i].Pin);
-				}
-				else
-				{
-					
-				}
-				break;
-	
-			case PORT_1:
-				if(INPUT == PinConfig_array[i].Direction)
-				{
-					CLR_BIT(IODIR1, PinConfig_array[i].Pin);
-				}
-				else if (OUTPUT == PinConfig_array[i].Direction)
-				{
-					SET_BIT(IODIR1, PinConfig_array[i].Pin);
-				}
-				else
-				{
-
-				}
-				break;
-	
-			default:
-		}
-	}
+	/* The levels go first, so that no pin drives a stale level once it is an
+	output, then each IODIR is written once with all its pins. */
+	IOCLR0 = GPIO_CFG_LOW_MASK(PORT_0);
+	IOSET0 = GPIO_CFG_HIGH_MASK(PORT_0);
+	IODIR0 = (IODIR0 & ~GPIO_CFG_USED_MASK(PORT_0)) | GPIO_CFG_OUTPUT_MASK(PORT_0);
+
+	IOCLR1 = GPIO_CFG_LOW_MASK(PORT_1);
+	IOSET1 = GPIO_CFG_HIGH_MASK(PORT_1);
+	IODIR1 = (IODIR1 & ~GPIO_CFG_USED_MASK(PORT_1)) | GPIO_CFG_OUTPUT_MASK(PORT_1);
 }
 
 
 pinState_t GPIO_read(portX_t PortName, pinX_t pinNum)
 {
-	pinState_t state;
+	pinState_t state = PIN_IS_LOW;
 	
 	switch(PortName)
 	{
@@ -74,6 +44,28 @@ pinState_t GPIO_read(portX_t PortName, pinX_t pinNum)
 }
 
 
+uint32_t GPIO_readPort(portX_t portName)
+{
+	uint32_t value = 0;
+	
+	switch(portName)
+	{
+		case PORT_0:
+			value = IOPIN0;
+			break;
+
+		case PORT_1:
+			value = IOPIN1;
+			break;
+
+		default:
+			break;
+	}
+	
+	return value;
+}
+
+
 void GPIO_write(portX_t portName, pinX_t pinNum, pinState_t pinState)
 {
 	switch(portName)
@@ -108,3 +100,31 @@ void GPIO_write(portX_t portName, pinX_t pinNum, pinState_t pinState)
 			}
 	}
 }
+
+
+void GPIO_writeMask(portX_t portName, uint32_t setMask, uint32_t clearMask)
+{
+	/* IOSET and IOCLR only act on the 1 bits written, no read-modify-write
+	is needed and the other pins are left alone. */
+	switch(portName)
+	{
+		case PORT_0:
+			IOSET0 = setMask;
+			IOCLR0 = clearMask;
+			break;
+
+		case PORT_1:
+			IOSET1 = setMask;
+			IOCLR1 = clearMask;
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+void GPIO_writePort(portX_t portName, uint32_t mask, uint32_t value)
+{
+	GPIO_writeMask(portName, value & mask, ~value & mask);
+}
@@ -3,39 +3,26 @@
 #include "GPIO_cfg.h"
 
 
-PinConfig_t PinConfig_array[] = 
+#define GPIO_CFG_ARRAY_ENTRY(unused, port, pin, dir, level)		{port, pin, dir, level},
+
+const PinConfig_t PinConfig_array[] = 
 							{
-								{PORT_0, PIN0, INPUT},
-								{PORT_0, PIN1, OUTPUT},
-								{PORT_0, PIN2, OUTPUT},
-								{PORT_0, PIN3, OUTPUT},
-								{PORT_0, PIN4, OUTPUT},
-								{PORT_0, PIN5, OUTPUT},
-								{PORT_0, PIN6, OUTPUT},
-								{PORT_0, PIN7, OUTPUT},
-								{PORT_0, PIN8, OUTPUT},
-								{PORT_0, PIN9, OUTPUT},
-								{PORT_0, PIN10, OUTPUT},
-								{PORT_0, PIN11, OUTPUT},
-								{PORT_0, PIN13, OUTPUT},
-								{PORT_0, PIN14, OUTPUT},
-								{PORT_0, PIN15, OUTPUT},
-								
-								{PORT_1, PIN0, OUTPUT},
-								{PORT_1, PIN1, OUTPUT},
-								{PORT_1, PIN2, OUTPUT},
-								{PORT_1, PIN3, OUTPUT},
-								{PORT_1, PIN4, OUTPUT},
-								{PORT_1, PIN5, OUTPUT},
-								{PORT_1, PIN6, OUTPUT},
-								{PORT_1, PIN7, OUTPUT},
-								{PORT_1, PIN8, OUTPUT},
-								{PORT_1, PIN9, OUTPUT},
-								{PORT_1, PIN10, OUTPUT},
-								{PORT_1, PIN11, OUTPUT},
-								{PORT_1, PIN13, OUTPUT},
-								{PORT_1, PIN14, OUTPUT},
-								{PORT_1, PIN15, OUTPUT},
+								GPIO_CFG_PIN_TABLE(GPIO_CFG_ARRAY_ENTRY, 0)
 							};
 
-uint16_t PinConfig_array_size = sizeof(PinConfig_array)/sizeof(PinConfig_t);
+const uint16_t PinConfig_array_size = sizeof(PinConfig_array)/sizeof(PinConfig_t);
+
+
+/* Static checks on the table.  A pin listed twice makes the sum of its port's
+pin bits differ from their OR; the bits are taken from PIN0 up so that the
+sum cannot overflow. */
+#define GPIO_CFG_SUM_BIT(wantPort, port, pin, dir, level)		+ (((port) == (wantPort)) ? (1UL << ((pin) - PIN0)) : 0UL)
+#define GPIO_CFG_INPUT_HIGH_BIT(wantPort, port, pin, dir, level)	| ((((port) == (wantPort)) && ((dir) == INPUT) && ((level) == PIN_IS_HIGH)) ? GPIO_PIN_MASK(pin) : 0UL)
+
+#define GPIO_CFG_NO_DUPLICATES(port)	((0UL GPIO_CFG_PIN_TABLE(GPIO_CFG_SUM_BIT, port)) == (GPIO_CFG_USED_MASK(port) >> PIN0))
+#define GPIO_CFG_NO_INPUT_HIGH(port)	((0UL GPIO_CFG_PIN_TABLE(GPIO_CFG_INPUT_HIGH_BIT, port)) == 0UL)
+
+typedef char GPIO_cfg_port0_pin_listed_twice[GPIO_CFG_NO_DUPLICATES(PORT_0) ? 1 : -1];
+typedef char GPIO_cfg_port1_pin_listed_twice[GPIO_CFG_NO_DUPLICATES(PORT_1) ? 1 : -1];
+typedef char GPIO_cfg_port0_input_set_high[GPIO_CFG_NO_INPUT_HIGH(PORT_0) ? 1 : -1];
+typedef char GPIO_cfg_port1_input_set_high[GPIO_CFG_NO_INPUT_HIGH(PORT_1) ? 1 : -1];
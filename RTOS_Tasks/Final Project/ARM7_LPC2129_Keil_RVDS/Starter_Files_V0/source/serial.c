@@ -58,8 +58,19 @@
 #define ser8_BIT_CHARS					( ( unsigned char ) 0x03 )
 #define serFIFO_ON						( ( unsigned char ) 0x01 )
 #define serCLEAR_FIFO					( ( unsigned char ) 0x06 )
+#define serRX_TRIGGER_8					( ( unsigned char ) 0x80 )
+#define serLSR_RDR						( ( unsigned char ) 0x01 )
+#define serLSR_OE						( ( unsigned char ) 0x02 )
 #define serWANTED_CLOCK_SCALING			( ( unsigned long ) 16 )
 
+/* Depth of the UART1 transmit FIFO.  A THRE interrupt means the FIFO is
+empty, so this many bytes can be written before the next one is needed. */
+#define serTX_FIFO_LENGTH				( 16 )
+
+/* The receive interrupt fires once this many bytes are in the FIFO, which
+leaves 8 character times to service it.  Matches serRX_TRIGGER_8. */
+#define serRX_TRIGGER_LEVEL				( 8 )
+
 /* Constants to setup and access the VIC. */
 #define serU1VIC_CHANNEL				( ( unsigned long ) 0x0007 )
 #define serU1VIC_CHANNEL_BIT			( ( unsigned long ) 0x0080 )
@@ -76,13 +87,111 @@
 #define serINTERRUPT_SOURCE_MASK		( ( unsigned char ) 0x0f )
 #define serINTERRUPT_IS_PENDING			( ( unsigned char ) 0x01 )
 
+/* Received byte that ends a frame, see vSerialSetRxFrameTask(). */
+#define serFRAME_DELIMITER				( ( unsigned char ) 0x00 )
+
+/* Trace hooks, may be defined in FreeRTOSConfig.h. */
+#ifndef traceUART_ISR_ENTER
+	#define traceUART_ISR_ENTER()
+#endif
+
+#ifndef traceUART_ISR_EXIT
+	#define traceUART_ISR_EXIT()
+#endif
+
+/* Transmit ring options, normally set in FreeRTOSConfig.h. */
+#ifndef configSERIAL_TX_BUFFER_SIZE
+	#define configSERIAL_TX_BUFFER_SIZE		( 256 )
+#endif
+
+#ifndef configSERIAL_TX_SINGLE_WRITER
+	#define configSERIAL_TX_SINGLE_WRITER	0
+#endif
+
+#ifndef configSERIAL_TX_BUFFERS
+	#define configSERIAL_TX_BUFFERS			( 8 )
+#endif
+
+#if ( ( configSERIAL_TX_BUFFER_SIZE & ( configSERIAL_TX_BUFFER_SIZE - 1 ) ) != 0 ) || ( configSERIAL_TX_BUFFER_SIZE > 32768 )
+	#error configSERIAL_TX_BUFFER_SIZE must be a power of two no larger than 32768
+#endif
+
+#if ( configSERIAL_TX_BUFFERS & ( configSERIAL_TX_BUFFERS - 1 ) ) != 0
+	#error configSERIAL_TX_BUFFERS must be a power of two
+#endif
+
+#ifndef configSERIAL_RX_BUFFER_SIZE
+	#define configSERIAL_RX_BUFFER_SIZE		( 128 )
+#endif
+
+#if ( configSERIAL_RX_BUFFER_SIZE & ( configSERIAL_RX_BUFFER_SIZE - 1 ) ) != 0
+	#error configSERIAL_RX_BUFFER_SIZE must be a power of two
+#endif
+
+#define serTX_RING_MASK					( ( unsigned long ) configSERIAL_TX_BUFFER_SIZE - 1UL )
+#define serRX_RING_MASK					( ( unsigned long ) configSERIAL_RX_BUFFER_SIZE - 1UL )
+#define serTX_BUFFER_MASK				( ( unsigned long ) configSERIAL_TX_BUFFERS - 1UL )
+
+/* Writers only have to exclude each other: the ISR never moves the head, so
+it is never masked while a writer copies into the ring. */
+#if ( configSERIAL_TX_SINGLE_WRITER == 1 )
+	#define serTX_WRITER_LOCK()
+	#define serTX_WRITER_UNLOCK()
+#else
+	#define serTX_WRITER_LOCK()			vTaskSuspendAll()
+	#define serTX_WRITER_UNLOCK()		( void ) xTaskResumeAll()
+#endif
+
 /*-----------------------------------------------------------*/
-unsigned char receivedChar;
-unsigned char isNewCharAvailable = 0;
 
-unsigned char txBuffer[200];
-unsigned char txDataSizeToSend;
-unsigned char txDataSizeLeftToSend;
+/* A caller's buffer queued by xSerialSendBuffer(), or one segment queued by
+xSerialSendv(), sent straight from the caller's memory. */
+typedef struct
+{
+	const unsigned char * pucData;
+	unsigned short usLength;
+	unsigned short usSent;			/* Bytes already in the FIFO, only the ISR changes it. */
+	unsigned long ulRingMark;		/* Ring head when queued, the ring bytes before it go first. */
+	TaskHandle_t xNotifyTask;		/* Notified once the data has left the FIFO, or NULL. */
+
+} SerialTxBuffer_t;
+
+/* Receive ring, the mirror image of the transmit one: only the ISR moves the
+head and only the reader moves the tail. */
+static volatile unsigned char ucRxRing[ configSERIAL_RX_BUFFER_SIZE ];
+static volatile unsigned long ulRxHead = 0;
+static volatile unsigned long ulRxTail = 0;
+static volatile unsigned long ulRxOverruns = 0;
+
+/* Notified once per burst of received bytes, see vSerialSetRxNotifyTask(). */
+static TaskHandle_t xRxNotifyTask = NULL;
+
+/* Notified once per frame delimiter received, see vSerialSetRxFrameTask().
+Only the ISR uses the other two: the ring position after the last delimiter,
+and whether the rest of the frame in progress is being thrown away. */
+static TaskHandle_t xRxFrameTask = NULL;
+static unsigned long ulRxFrameStart = 0;
+static portBASE_TYPE xRxFrameDropped = pdFALSE;
+
+/* Transmit ring.  Writers move the head and only the ISR moves the tail, both
+are free running and masked on access, so head - tail is the fill level. */
+static volatile unsigned char ucTxRing[ configSERIAL_TX_BUFFER_SIZE ];
+static volatile unsigned long ulTxHead = 0;
+static volatile unsigned long ulTxTail = 0;
+static unsigned short usTxHighWaterMark = 0;
+
+/* Queued caller buffers.  Writers move the head; the ISR moves the next index
+as it sends them and the tail as it hands them back to their owners. */
+static SerialTxBuffer_t xTxBuffers[ configSERIAL_TX_BUFFERS ];
+static volatile unsigned long ulTxBufferHead = 0;
+static volatile unsigned long ulTxBufferNext = 0;
+static volatile unsigned long ulTxBufferTail = 0;
+
+/* Set by the ISR when a THRE interrupt found nothing left to send.  No
+interrupt is coming after that, so the next writer has to restart the
+transmission. */
+static volatile portBASE_TYPE xTxIdle = pdTRUE;
+
 /*
  * The asm wrapper for the interrupt service routine.
  */
@@ -93,6 +202,34 @@ extern void vUART_ISREntry( void );
  */
 void vUART_ISRHandler( void );
 
+/*
+ * Moves up to serTX_FIFO_LENGTH bytes from the ring and the queued caller
+ * buffers to U1THR, in the order they were queued, and returns how many it
+ * moved.  Only called when the transmit FIFO is empty.
+ */
+static unsigned char prvFillTxFifo( void );
+
+/*
+ * Restarts the transmission after the ISR went idle.  Called by writers with
+ * the writer lock held, after they published new data.
+ */
+static void prvTxStart( void );
+
+/*
+ * Appends to the ring and restarts the transmission if it had stopped.
+ * Copies as much as fits, or nothing unless all of it fits when xWhole is
+ * pdTRUE, and returns the number of bytes taken.
+ */
+static unsigned short prvTxWrite( const signed char * pcData, unsigned short usLength, portBASE_TYPE xWhole );
+
+/*
+ * Moves received bytes from the FIFO to the ring, at most ulMax of them, and
+ * returns the ring fill level before the first one.  Every frame delimiter
+ * stored notifies the frame task, if there is one, and a frame that does not
+ * fit is dropped whole.
+ */
+static unsigned long prvDrainRxFifo( unsigned long ulMax, portBASE_TYPE * pxHigherPriorityTaskWoken );
+
 /*-----------------------------------------------------------*/
 
 void xSerialPortInitMinimal( unsigned long ulWantedBaud)
@@ -116,7 +253,7 @@ void xSerialPortInitMinimal( unsigned long ulWantedBaud)
 	U1DLM = ( unsigned char ) ( ulDivisor & ( unsigned long ) 0xff );
 
 	/* Turn on the FIFO's and clear the buffers. */
-	U1FCR = ( serFIFO_ON | serCLEAR_FIFO );
+	U1FCR = ( serFIFO_ON | serCLEAR_FIFO | serRX_TRIGGER_8 );
 
 	/* Setup transmission format. */
 	U1LCR = serNO_PARITY | ser1_STOP_BIT | ser8_BIT_CHARS;
@@ -135,11 +272,9 @@ void xSerialPortInitMinimal( unsigned long ulWantedBaud)
 signed portBASE_TYPE xSerialGetChar(signed char *pcRxedChar)
 {
 	/* Get the next character from the buffer.  Return false if no characters
-	are available, or arrive before xBlockTime expires. */
-	if(isNewCharAvailable == 1U)
+	are available. */
+	if( usSerialRead( pcRxedChar, 1U ) == 1U )
 	{
-		isNewCharAvailable = 0U;
-		*pcRxedChar = receivedChar;
 		return pdTRUE;
 	}
 	else
@@ -149,23 +284,80 @@ signed portBASE_TYPE xSerialGetChar(signed char *pcRxedChar)
 }
 /*-----------------------------------------------------------*/
 
-signed portBASE_TYPE vSerialPutString(const signed char * const pcString, unsigned short usStringLength )
+unsigned short usSerialRead( signed char * const pcBuffer, unsigned short usMax )
 {
-	int i;
+unsigned long ulTail = ulRxTail;
+const unsigned long ulHead = ulRxHead;
+unsigned short x;
 
-	if(txDataSizeLeftToSend == 0 && pcString != NULL)
+	for( x = 0; ( x < usMax ) && ( ulTail != ulHead ); x++ )
 	{
-	  txDataSizeToSend = usStringLength;
-	  txDataSizeLeftToSend = usStringLength;
-	
-	  for(i = 0;i < usStringLength; i++)
-	  {
-		  txBuffer[i] = pcString[i];
-	  }
-	
-	  xSerialPutChar(txBuffer[txDataSizeToSend - txDataSizeLeftToSend--]);
-		
-	  return pdTRUE;
+		pcBuffer[ x ] = ( signed char ) ucRxRing[ ulTail & serRX_RING_MASK ];
+		ulTail++;
+	}
+
+	/* Frees the space for the ISR only after the bytes were copied out. */
+	ulRxTail = ulTail;
+
+	return x;
+}
+/*-----------------------------------------------------------*/
+
+void vSerialSetRxNotifyTask( TaskHandle_t xTask )
+{
+	xRxNotifyTask = xTask;
+}
+/*-----------------------------------------------------------*/
+
+unsigned short usSerialReadFrame( signed char * const pcBuffer, unsigned short usMax )
+{
+unsigned long ulTail = ulRxTail;
+const unsigned long ulHead = ulRxHead;
+unsigned short x = 0;
+unsigned char ucChar;
+
+	while( ( x < usMax ) && ( ulTail != ulHead ) )
+	{
+		ucChar = ucRxRing[ ulTail & serRX_RING_MASK ];
+		pcBuffer[ x++ ] = ( signed char ) ucChar;
+		ulTail++;
+
+		if( ucChar == serFRAME_DELIMITER )
+		{
+			break;
+		}
+	}
+
+	ulRxTail = ulTail;
+
+	return x;
+}
+/*-----------------------------------------------------------*/
+
+void vSerialSetRxFrameTask( TaskHandle_t xTask )
+{
+	/* Whatever is in the ring already counts as the start of the first frame. */
+	taskENTER_CRITICAL();
+	{
+		xRxFrameTask = xTask;
+		ulRxFrameStart = ulRxTail;
+		xRxFrameDropped = pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulSerialGetRxOverruns( void )
+{
+	return ulRxOverruns;
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE vSerialPutString(const signed char * const pcString, unsigned short usStringLength )
+{
+	if( ( pcString != NULL ) && ( prvTxWrite( pcString, usStringLength, pdTRUE ) == usStringLength ) )
+	{
+		return pdTRUE;
 	}
 	else
 	{
@@ -174,9 +366,287 @@ signed portBASE_TYPE vSerialPutString(const signed char * const pcString, unsign
 }
 /*-----------------------------------------------------------*/
 
+unsigned short usSerialWrite( const signed char * const pcData, unsigned short usLength )
+{
+	if( pcData == NULL )
+	{
+		return 0U;
+	}
+
+	return prvTxWrite( pcData, usLength, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
 void xSerialPutChar(signed char cOutChar)
 {
-	U1THR = cOutChar;
+	( void ) prvTxWrite( &cOutChar, 1U, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+unsigned short usSerialGetTxHighWaterMark( void )
+{
+	return usTxHighWaterMark;
+}
+/*-----------------------------------------------------------*/
+
+unsigned short usSerialGetTxFree( void )
+{
+	/* Only grows behind the caller's back, as the ISR moves the tail. */
+	return ( unsigned short ) ( configSERIAL_TX_BUFFER_SIZE - ( ulTxHead - ulTxTail ) );
+}
+/*-----------------------------------------------------------*/
+
+static unsigned short prvTxWrite( const signed char * pcData, unsigned short usLength, portBASE_TYPE xWhole )
+{
+unsigned long ulHead, ulUsed, x;
+
+	serTX_WRITER_LOCK();
+	{
+		ulHead = ulTxHead;
+		ulUsed = ulHead - ulTxTail;
+
+		if( ( unsigned long ) usLength > ( configSERIAL_TX_BUFFER_SIZE - ulUsed ) )
+		{
+			usLength = ( xWhole != pdFALSE ) ? 0U : ( unsigned short ) ( configSERIAL_TX_BUFFER_SIZE - ulUsed );
+		}
+
+		for( x = 0; x < usLength; x++ )
+		{
+			ucTxRing[ ( ulHead + x ) & serTX_RING_MASK ] = ( unsigned char ) pcData[ x ];
+		}
+
+		/* The ISR only sees the new bytes once the head moves past them. */
+		ulTxHead = ulHead + usLength;
+
+		ulUsed += usLength;
+		if( ulUsed > usTxHighWaterMark )
+		{
+			usTxHighWaterMark = ( unsigned short ) ulUsed;
+		}
+
+		if( usLength > 0U )
+		{
+			prvTxStart();
+		}
+	}
+	serTX_WRITER_UNLOCK();
+
+	return usLength;
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE xSerialSendBuffer( const void * const pvData, unsigned short usLength, TaskHandle_t xNotifyTask )
+{
+SerialSegment_t xSegment;
+
+	xSegment.pvData = pvData;
+	xSegment.usLength = usLength;
+
+	return xSerialSendv( &xSegment, 1U, xNotifyTask );
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE xSerialSendv( const SerialSegment_t * const pxSegments, UBaseType_t uxCount, TaskHandle_t xNotifyTask )
+{
+signed portBASE_TYPE xReturn = pdFALSE;
+SerialTxBuffer_t * pxBuffer = NULL;
+unsigned long ulHead, ulNeeded = 0UL;
+UBaseType_t x;
+
+	if( pxSegments == NULL )
+	{
+		return pdFALSE;
+	}
+
+	/* Empty segments are skipped, the ISR could not tell them apart from a
+	finished one. */
+	for( x = 0; x < uxCount; x++ )
+	{
+		if( ( pxSegments[ x ].pvData != NULL ) && ( pxSegments[ x ].usLength > 0U ) )
+		{
+			ulNeeded++;
+		}
+	}
+
+	if( ( ulNeeded == 0UL ) || ( ulNeeded > configSERIAL_TX_BUFFERS ) )
+	{
+		return pdFALSE;
+	}
+
+	serTX_WRITER_LOCK();
+	{
+		ulHead = ulTxBufferHead;
+
+		if( ( configSERIAL_TX_BUFFERS - ( ulHead - ulTxBufferTail ) ) >= ulNeeded )
+		{
+			for( x = 0; x < uxCount; x++ )
+			{
+				if( ( pxSegments[ x ].pvData != NULL ) && ( pxSegments[ x ].usLength > 0U ) )
+				{
+					/* All segments carry the same ring mark, so the ISR sends
+					them one after the other before any ring byte queued
+					after them. */
+					pxBuffer = &xTxBuffers[ ulHead & serTX_BUFFER_MASK ];
+					pxBuffer->pucData = ( const unsigned char * ) pxSegments[ x ].pvData;
+					pxBuffer->usLength = pxSegments[ x ].usLength;
+					pxBuffer->usSent = 0U;
+					pxBuffer->ulRingMark = ulTxHead;
+					pxBuffer->xNotifyTask = NULL;
+					ulHead++;
+				}
+			}
+
+			pxBuffer->xNotifyTask = xNotifyTask;
+
+			/* As with the ring, the ISR only looks at the entries once the
+			head has moved past them, and it moves past all of them at once. */
+			ulTxBufferHead = ulHead;
+
+			prvTxStart();
+			xReturn = pdTRUE;
+		}
+	}
+	serTX_WRITER_UNLOCK();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTxStart( void )
+{
+	/* The idle flag cannot be set after this test while data is left to
+	send, so either the ISR sends the new data or the code below does. */
+	if( xTxIdle != pdFALSE )
+	{
+		taskENTER_CRITICAL();
+		{
+			xTxIdle = pdFALSE;
+			( void ) prvFillTxFifo();
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long prvDrainRxFifo( unsigned long ulMax, portBASE_TYPE * pxHigherPriorityTaskWoken )
+{
+unsigned long ulHead = ulRxHead;
+const unsigned long ulUsed = ulHead - ulRxTail;
+const TaskHandle_t xFrameTask = xRxFrameTask;
+unsigned char ucStatus, ucChar;
+
+	while( ulMax > 0U )
+	{
+		ucStatus = U1LSR;
+
+		if( ( ucStatus & serLSR_OE ) != 0U )
+		{
+			ulRxOverruns++;
+		}
+
+		if( ( ucStatus & serLSR_RDR ) == 0U )
+		{
+			break;
+		}
+
+		ucChar = U1RBR;
+
+		if( xFrameTask == NULL )
+		{
+			if( ( ulHead - ulRxTail ) < configSERIAL_RX_BUFFER_SIZE )
+			{
+				ucRxRing[ ulHead & serRX_RING_MASK ] = ucChar;
+				ulHead++;
+			}
+			else
+			{
+				/* The reader is too slow, the byte has to go. */
+				ulRxOverruns++;
+			}
+		}
+		else if( xRxFrameDropped != pdFALSE )
+		{
+			/* The rest of a frame that did not fit. */
+			ulRxOverruns++;
+			if( ucChar == serFRAME_DELIMITER )
+			{
+				xRxFrameDropped = pdFALSE;
+			}
+		}
+		else if( ( ulHead - ulRxTail ) < configSERIAL_RX_BUFFER_SIZE )
+		{
+			ucRxRing[ ulHead & serRX_RING_MASK ] = ucChar;
+			ulHead++;
+
+			if( ucChar == serFRAME_DELIMITER )
+			{
+				/* The frame has to be in the ring before its reader runs. */
+				ulRxHead = ulHead;
+				ulRxFrameStart = ulHead;
+				vTaskNotifyGiveFromISR( xFrameTask, pxHigherPriorityTaskWoken );
+			}
+		}
+		else
+		{
+			/* The frame in progress cannot be completed, so none of it is
+			kept: its bytes are given back to the frames that follow, which
+			would otherwise be cut short too.  The reader only takes whole
+			frames, so it has not started on this one. */
+			ulRxOverruns += ( ulHead - ulRxFrameStart ) + 1UL;
+			ulHead = ulRxFrameStart;
+			xRxFrameDropped = ( ucChar != serFRAME_DELIMITER ) ? pdTRUE : pdFALSE;
+		}
+
+		ulMax--;
+	}
+
+	ulRxHead = ulHead;
+
+	return ulUsed;
+}
+/*-----------------------------------------------------------*/
+
+static unsigned char prvFillTxFifo( void )
+{
+unsigned long ulTail = ulTxTail;
+const unsigned long ulHead = ulTxHead;
+unsigned long ulNext = ulTxBufferNext;
+const unsigned long ulBufferHead = ulTxBufferHead;
+SerialTxBuffer_t * pxBuffer;
+unsigned char ucWritten = 0U;
+
+	while( ucWritten < serTX_FIFO_LENGTH )
+	{
+		pxBuffer = &xTxBuffers[ ulNext & serTX_BUFFER_MASK ];
+
+		if( ( ulNext != ulBufferHead ) && ( pxBuffer->ulRingMark == ulTail ) )
+		{
+			/* Every ring byte queued before this buffer has gone. */
+			U1THR = pxBuffer->pucData[ pxBuffer->usSent ];
+			pxBuffer->usSent++;
+
+			if( pxBuffer->usSent == pxBuffer->usLength )
+			{
+				ulNext++;
+			}
+		}
+		else if( ulTail != ulHead )
+		{
+			U1THR = ucTxRing[ ulTail & serTX_RING_MASK ];
+			ulTail++;
+		}
+		else
+		{
+			break;
+		}
+
+		ucWritten++;
+	}
+
+	ulTxTail = ulTail;
+	ulTxBufferNext = ulNext;
+
+	return ucWritten;
 }
 /*-----------------------------------------------------------*/
 
@@ -184,6 +654,10 @@ void vUART_ISRHandler( void )
 {
 signed char cChar;
 unsigned char ucInterrupt;
+unsigned long ulUsed;
+portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	traceUART_ISR_ENTER();
 
 	ucInterrupt = U1IIR;
 
@@ -193,25 +667,61 @@ unsigned char ucInterrupt;
 		/* What caused the interrupt? */
 		switch( ucInterrupt & serINTERRUPT_SOURCE_MASK )
 		{
-			case serSOURCE_ERROR :	/* Not handling this, but clear the interrupt. */
+			case serSOURCE_ERROR :	/* Only overruns are counted, but clear the interrupt. */
 				cChar = U1LSR;
+				if( ( ( unsigned char ) cChar & serLSR_OE ) != 0U )
+				{
+					ulRxOverruns++;
+				}
 				break;
 	
 			case serSOURCE_THRE	:	/* The THRE is empty */
 				
-				/* Do nothing */
-				if(txDataSizeLeftToSend > 0)
+				/* Buffers sent by the last fill have left the FIFO, so their
+				owners can have them back. */
+				while( ulTxBufferTail != ulTxBufferNext )
+				{
+					if( xTxBuffers[ ulTxBufferTail & serTX_BUFFER_MASK ].xNotifyTask != NULL )
+					{
+						vTaskNotifyGiveFromISR( xTxBuffers[ ulTxBufferTail & serTX_BUFFER_MASK ].xNotifyTask, &xHigherPriorityTaskWoken );
+					}
+					ulTxBufferTail++;
+				}
+
+				/* The whole FIFO is empty, refill it rather than taking an
+				interrupt for every character. */
+				if( prvFillTxFifo() == 0U )
 				{
-					U1THR = txBuffer[txDataSizeToSend - txDataSizeLeftToSend--];
+					xTxIdle = pdTRUE;
 				}
 				
 				break;
 	
-			case serSOURCE_RX_TIMEOUT :
-			case serSOURCE_RX	:	/* A character was received */
-			
-				receivedChar = U1RBR;
-				isNewCharAvailable = 1U;			
+			case serSOURCE_RX_TIMEOUT :	/* The line went idle, the burst is over */
+
+				/* Take everything that is left and wake the reader, once
+				for the whole burst. */
+				( void ) prvDrainRxFifo( ~0UL, &xHigherPriorityTaskWoken );
+				if( xRxNotifyTask != NULL )
+				{
+					vTaskNotifyGiveFromISR( xRxNotifyTask, &xHigherPriorityTaskWoken );
+				}
+				break;
+
+			case serSOURCE_RX	:	/* The FIFO reached its trigger level */
+
+				/* The FIFO holds at least serRX_TRIGGER_LEVEL bytes.  One is
+				left behind so that the character timeout still fires when
+				the burst ends, whatever its length. */
+				ulUsed = prvDrainRxFifo( serRX_TRIGGER_LEVEL - 1UL, &xHigherPriorityTaskWoken );
+
+				/* A burst longer than half the ring would overrun it before
+				the timeout, so wake the reader on the way too. */
+				if( ( xRxNotifyTask != NULL ) && ( ulUsed < ( configSERIAL_RX_BUFFER_SIZE / 2UL ) ) &&
+					( ( ulRxHead - ulRxTail ) >= ( configSERIAL_RX_BUFFER_SIZE / 2UL ) ) )
+				{
+					vTaskNotifyGiveFromISR( xRxNotifyTask, &xHigherPriorityTaskWoken );
+				}
 				break;
 	
 			default:	/* There is nothing to do, leave the ISR. */
@@ -223,6 +733,11 @@ unsigned char ucInterrupt;
 
 	/* Clear the ISR in the VIC. */
 	VICVectAddr = serCLEAR_VIC_INTERRUPT;
+
+	traceUART_ISR_EXIT();
+
+	/* If the reader was woken the asm wrapper switches to it on the way out. */
+	portEXIT_SWITCHING_ISR( xHigherPriorityTaskWoken );
 }
 /*-----------------------------------------------------------*/
 
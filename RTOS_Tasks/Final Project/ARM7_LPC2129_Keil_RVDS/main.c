@@ -20,6 +20,17 @@
 /* Peripheral includes. */
 #include "serial.h"
 #include "GPIO.h"
+#include "GPIO_fast.h"
+
+/* EDF includes. */
+#include "edf_admission.h"
+#include "task_monitor.h"
+#include "cpu_load.h"
+#include "cpu_burn.h"
+#include "task_table.h"
+
+/* Task set generated from Simso.xml by Tools/simso_tasks. */
+#include "simso_tasks.h"
 
 
 
@@ -33,6 +44,7 @@
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
 
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -47,48 +59,28 @@ static void prvSetupHardware( void );
 /*-----------------------------------------------------------*/
 
 
-TaskHandle_t task1_Handle =NULL;
-TaskHandle_t task2_Handle =NULL;
+TaskHandle_t xTaskHandles[ simsoNUMBER_OF_TASKS ];
 
 
 
-TaskTimingParameters task1Time,task2Time;
 uint8_t CPU_load =0;
 
 /*-----------------------------------------------------------*/
-void task1(void * pvParameters) /* Execution time = 2ms - Deadline = 5ms */
-{
-	TickType_t xLastWakeTime1;
-	uint32_t i=0;
-	//TickType_t StartTime,EndTime;
-  xLastWakeTime1 = xTaskGetTickCount();
-	/* This task is going to be represented by a voltage scale of 1. */
-   vTaskSetApplicationTaskTag( task1_Handle, (TaskHookFunction_t ) 1 );
-	for( ; ; ) 
-	{
-		/* IDLE task */
-		GPIO_write(PORT_0,PIN2,PIN_IS_LOW);
-		for(i=0;i<15000;i++)
-		{
-			i = i;
-		}
-		vTaskDelayUntil( &xLastWakeTime1, 5); /* 10 ms*/ 
-	}
-}
-void task2(void * pvParameters)
+/* Job body of every task in simso_tasks.h.  The table row it was created
+from gives its execution time and period. */
+void vPeriodicJob(void * pvParameters)
 {
-	TickType_t xLastWakeTime2;
-	uint32_t i=0;
-	xLastWakeTime2 = xTaskGetTickCount();
-  vTaskSetApplicationTaskTag( task2_Handle, (TaskHookFunction_t ) 2 );
+	const PeriodicTaskConfig_t * const pxConfig = (const PeriodicTaskConfig_t *) pvParameters;
+	TickType_t xLastWakeTime;
+
+	xLastWakeTime = xTaskGetTickCount();
+	/* The task tag is set by the task monitor at creation. */
 	for( ; ; ) 
 	{
 		/* IDLE task */
-		GPIO_write(PORT_0,PIN2,PIN_IS_LOW);
-		for(i=0;i<20000;i++) 
-			i = i;
-
-		vTaskDelayUntil( &xLastWakeTime2, 20 );		
+		GPIO_FAST_CLR(PORT_0,PIN2);
+		vBurnCpuMicroseconds(pxConfig->ulWcetUs);
+		vTaskDelayUntilChecked( &xLastWakeTime, pxConfig->xPeriod );
 	}
 }
 
@@ -96,18 +88,30 @@ void task2(void * pvParameters)
 void vApplicationTickHook( void )
 {	
 	/* Tick */
-	GPIO_write(PORT_0,PIN1,PIN_IS_HIGH);
-	GPIO_write(PORT_0,PIN1,PIN_IS_LOW);
-	
-	/* CPU load */
-	CPU_load=((float)(task1Time.TotalExecution + task2Time.TotalExecution)/(T1TC))*100;
-	
+	GPIO_FAST_SET(PORT_0,PIN1);
+	GPIO_FAST_CLR(PORT_0,PIN1);
 }
 
 void vApplicationIdleHook( void )
 {
 	/* IDLE task*/
-	GPIO_write(PORT_0,PIN2,PIN_IS_HIGH);
+	GPIO_FAST_SET(PORT_0,PIN2);
+	
+	/* Idle time in its own slot, apart from the untagged tasks */
+	vTaskMonitorIdleHook();
+	
+	/* CPU load over the last second, in percent */
+	CPU_load = (uint8_t)(ulCPULoadGetTotal(loadWINDOW_1S) / 10);
+	
+	/* Send pending trace events over UART1 */
+	vTraceRingDrain();
+}
+
+/* Implement Deadline Miss Hook */
+void vApplicationDeadlineMissHook( TaskHandle_t xTask, TickType_t xLateness )
+{
+	/* Latch PIN11 high on the first miss so overload is visible on the probe */
+	GPIO_FAST_SET(PORT_0,PIN11);
 }
 /*-----------------------------------------------------------*/
 
@@ -122,12 +126,14 @@ int main( void )
 
 	
   /* Create Tasks here */
-  xTaskPeriodicCreate(task1,"Task1",100,NULL,1,&task1_Handle,5);
-	xTaskPeriodicCreate(task2,"Task2",100,NULL,1,&task2_Handle,15);
-	
-	/* Initialize tasks Exection time to zero */
-	task1Time.TotalExecution =0;
-  task2Time.TotalExecution =0;
+  /* Periods, deadlines, WCETs and probe pins as analysed in Simso.xml */
+  if(xTaskTableCreate(xSimsoTasks, simsoNUMBER_OF_TASKS, xTaskHandles) != pdPASS)
+  {
+	/* Admission control refused a task or the heap ran out.  Only part of the
+	analysed set would run, so stop here with the miss probe PIN11 latched. */
+	GPIO_FAST_SET(PORT_0,PIN11);
+	for( ;; );
+  }
 	
   vTaskStartScheduler();
 
@@ -150,7 +156,7 @@ void ResetTimer1()
 
 static void configTimer1()
 {
-	T1PR =1000; /* 20 khz  */
+	T1PR =configTRACE_TIMER_PRESCALE; /* 60 MHz / 1001 = ~60 khz */
 	T1TCR |=0x01;
 }
 /*-----------------------------------------------------------*/
@@ -168,9 +174,15 @@ static void prvSetupHardware( void )
 	
 	/* Configure Trace Timer 1 and read T1TC to get the current tick */
 	configTimer1();
+	
+	/* Start the CPU load windows from the Timer 1 start */
+	vCPULoadInit();
 
 	/* Setup the peripheral bus to be the same as the PLL output. */
 	VPBDIV = mainBUS_CLK_FULL;
+
+	/* Time the CPU burner against Timer 1 at the final bus clock */
+	vBurnCpuCalibrate();
 }
 
 
@@ -27,10 +27,20 @@
 
 
 /* 
-	BASIC INTERRUPT DRIVEN SERIAL PORT DRIVER FOR UART0. 
-
-	Note this driver is used to test the FreeRTOS port.  It is NOT intended to
-	be an example of an efficient implementation!
+	INTERRUPT DRIVEN SERIAL PORT DRIVER FOR UART1.
+
+	Characters move between the tasks and the UART through two stream
+	buffers.  vSerialPutString() copies a whole string into the transmit
+	buffer with one call, and the THRE interrupt takes up to a FIFO full back
+	out with one call, where the queue based version of this driver paid a
+	queue operation per character on both sides.  Received characters are
+	likewise moved out of the RX FIFO in bursts.
+
+	A stream buffer allows one writer and one reader at a time, so tasks
+	sharing the port serialise on the xTxLock and xRxLock semaphores.  The
+	ISR is the only other reader of the transmit buffer and the only writer
+	of the receive buffer, and the tasks that start a transmission read the
+	transmit buffer inside a critical section, where the ISR cannot run.
 */
 
 /* Standard includes. */
@@ -38,8 +48,9 @@
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
-#include "queue.h"
 #include "task.h"
+#include "semphr.h"
+#include "stream_buffer.h"
 
 /* Demo application includes. */
 #include "serial.h"
@@ -54,17 +65,26 @@
 #define ser8_BIT_CHARS					( ( unsigned char ) 0x03 )
 #define serFIFO_ON						( ( unsigned char ) 0x01 )
 #define serCLEAR_FIFO					( ( unsigned char ) 0x06 )
+#define serRX_TRIGGER_8					( ( unsigned char ) 0x80 )
 #define serWANTED_CLOCK_SCALING			( ( unsigned long ) 16 )
 
+/* Line status bit set while the RX FIFO holds a character. */
+#define serLSR_RDR						( ( unsigned char ) 0x01 )
+
+/* Both UART FIFOs are 16 bytes deep. */
+#define serFIFO_LENGTH					( 16 )
+
 /* Constants to setup and access the VIC. */
 #define serU1VIC_CHANNEL				( ( unsigned long ) 0x0007 )
 #define serU1VIC_CHANNEL_BIT			( ( unsigned long ) 0x0080 )
 #define serU1VIC_ENABLE					( ( unsigned long ) 0x0020 )
 
 /* Misc. */
-#define serINVALID_QUEUE				( ( QueueHandle_t ) 0 )
+#define serINVALID_BUFFER				( ( StreamBufferHandle_t ) 0 )
+#define serINVALID_LOCK					( ( SemaphoreHandle_t ) 0 )
 #define serHANDLE						( ( xComPortHandle ) 1 )
 #define serNO_BLOCK						( ( TickType_t ) 0 )
+#define serTRIGGER_LEVEL				( ( size_t ) 1 )
 
 /* Constant to access the VIC. */
 #define serCLEAR_VIC_INTERRUPT			( ( unsigned long ) 0 )
@@ -89,12 +109,28 @@ extern void vUART_ISREntry( void );
  */
 void vUART_ISRHandler( void );
 
+/*
+ * Copies up to usLength bytes into the transmit buffer, waiting at most
+ * xBlockTime for the lock and for space, then starts the transmitter if it
+ * is idle.  Returns the number of bytes copied.
+ */
+static size_t prvSend( const signed char * const pcData, unsigned short usLength, TickType_t xBlockTime );
+
+/*
+ * Writes the first FIFO full of the transmit buffer to the idle UART.
+ */
+static void prvStartTx( void );
+
 /*-----------------------------------------------------------*/
 
-/* Queues used to hold received characters, and characters waiting to be
-transmitted. */
-static QueueHandle_t xRxedChars; 
-static QueueHandle_t xCharsForTx; 
+/* Stream buffers used to hold received characters, and characters waiting
+to be transmitted. */
+static StreamBufferHandle_t xRxedChars; 
+static StreamBufferHandle_t xCharsForTx; 
+
+/* Serialise the tasks that write to, or read from, the port. */
+static SemaphoreHandle_t xTxLock;
+static SemaphoreHandle_t xRxLock;
 
 /* Communication flag between the interrupt service routine and serial API. */
 static volatile long lTHREEmpty;
@@ -106,20 +142,28 @@ xComPortHandle xSerialPortInitMinimal( unsigned long ulWantedBaud, unsigned port
 unsigned long ulDivisor, ulWantedClock;
 xComPortHandle xReturn = serHANDLE;
 
-	/* Create the queues used to hold Rx and Tx characters. */
-	xRxedChars = xQueueCreate( uxQueueLength, ( unsigned portBASE_TYPE ) sizeof( signed char ) );
-	xCharsForTx = xQueueCreate( uxQueueLength + 1, ( unsigned portBASE_TYPE ) sizeof( signed char ) );
+	/* Create the buffers used to hold Rx and Tx characters, and the locks
+	that let several tasks share them. */
+	xRxedChars = xStreamBufferCreate( ( size_t ) uxQueueLength, serTRIGGER_LEVEL );
+	xCharsForTx = xStreamBufferCreate( ( size_t ) uxQueueLength + 1U, serTRIGGER_LEVEL );
+	xTxLock = xSemaphoreCreateBinary();
+	xRxLock = xSemaphoreCreateBinary();
 
 	/* Initialise the THRE empty flag. */
 	lTHREEmpty = pdTRUE;
 
 	if( 
-		( xRxedChars != serINVALID_QUEUE ) && 
-		( xCharsForTx != serINVALID_QUEUE ) && 
+		( xRxedChars != serINVALID_BUFFER ) && 
+		( xCharsForTx != serINVALID_BUFFER ) && 
+		( xTxLock != serINVALID_LOCK ) && 
+		( xRxLock != serINVALID_LOCK ) && 
 		( ulWantedBaud != ( unsigned long ) 0 ) 
 	  )
 	{
-		portENTER_CRITICAL()
+		xSemaphoreGive( xTxLock );
+		xSemaphoreGive( xRxLock );
+
+		portENTER_CRITICAL();
 		{
 			/* Setup the baud rate:  Calculate the divisor value. */
 			ulWantedClock = ulWantedBaud * serWANTED_CLOCK_SCALING;
@@ -133,8 +177,10 @@ xComPortHandle xReturn = serHANDLE;
 			ulDivisor >>= 8;
 			U1DLM = ( unsigned char ) ( ulDivisor & ( unsigned long ) 0xff );
 
-			/* Turn on the FIFO's and clear the buffers. */
-			U1FCR = ( serFIFO_ON | serCLEAR_FIFO );
+			/* Turn on the FIFO's and clear the buffers.  The receive
+			interrupt comes every 8 characters, or after a pause in the
+			line with fewer waiting. */
+			U1FCR = ( serFIFO_ON | serCLEAR_FIFO | serRX_TRIGGER_8 );
 
 			/* Setup transmission format. */
 			U1LCR = serNO_PARITY | ser1_STOP_BIT | ser8_BIT_CHARS;
@@ -145,7 +191,7 @@ xComPortHandle xReturn = serHANDLE;
 			VICVectAddr1 = ( unsigned long ) vUART_ISREntry;
 			VICVectCntl1 = serU1VIC_CHANNEL | serU1VIC_ENABLE;
 
-			/* Enable UART0 interrupts. */
+			/* Enable UART1 interrupts. */
 			U1IER |= serENABLE_INTERRUPTS;
 		}
 		portEXIT_CRITICAL();
@@ -161,90 +207,112 @@ xComPortHandle xReturn = serHANDLE;
 
 signed portBASE_TYPE xSerialGetChar( xComPortHandle pxPort, signed char *pcRxedChar, TickType_t xBlockTime )
 {
-	/* The port handle is not required as this driver only supports UART0. */
+TimeOut_t xTimeOut;
+size_t xReceived = 0;
+
+	/* The port handle is not required as this driver only supports UART1. */
 	( void ) pxPort;
 
 	/* Get the next character from the buffer.  Return false if no characters
-	are available, or arrive before xBlockTime expires. */
-	if( xQueueReceive( xRxedChars, pcRxedChar, xBlockTime ) )
+	are available, or arrive before xBlockTime expires.  The lock and the
+	character share the one block time. */
+	vTaskSetTimeOutState( &xTimeOut );
+	if( xSemaphoreTake( xRxLock, xBlockTime ) == pdTRUE )
 	{
-		return pdTRUE;
-	}
-	else
-	{
-		return pdFALSE;
+		( void ) xTaskCheckForTimeOut( &xTimeOut, &xBlockTime );
+		xReceived = xStreamBufferReceive( xRxedChars, pcRxedChar, sizeof( signed char ), xBlockTime );
+		xSemaphoreGive( xRxLock );
 	}
+
+	return ( xReceived != 0U ) ? pdTRUE : pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
 void vSerialPutString( xComPortHandle pxPort, const signed char * const pcString, unsigned short usStringLength )
 {
-signed char *pxNext;
+	/* The port handle is not required as this driver only supports UART1. */
+	( void ) pxPort;
 
-	/* NOTE: This implementation does not handle the queue being full as no
-	block time is used! */
+	/* NOTE: As before no block time is used, so characters that do not fit
+	in the transmit buffer are dropped. */
+	( void ) prvSend( pcString, usStringLength, serNO_BLOCK );
+}
+/*-----------------------------------------------------------*/
 
-	/* The port handle is not required as this driver only supports UART0. */
+signed portBASE_TYPE xSerialPutChar( xComPortHandle pxPort, signed char cOutChar, TickType_t xBlockTime )
+{
+	/* The port handle is not required as this driver only supports UART1. */
 	( void ) pxPort;
-	( void ) usStringLength;
 
-	/* Send each character in the string, one at a time. */
-	pxNext = ( signed char * ) pcString;
-	while( *pxNext )
-	{
-		xSerialPutChar( pxPort, *pxNext, serNO_BLOCK );
-		pxNext++;
-	}
+	return ( prvSend( &cOutChar, 1U, xBlockTime ) != 0U ) ? pdPASS : pdFAIL;
 }
 /*-----------------------------------------------------------*/
 
-signed portBASE_TYPE xSerialPutChar( xComPortHandle pxPort, signed char cOutChar, TickType_t xBlockTime )
+static size_t prvSend( const signed char * const pcData, unsigned short usLength, TickType_t xBlockTime )
 {
-signed portBASE_TYPE xReturn;
+TimeOut_t xTimeOut;
+size_t xSent = 0;
 
-	/* The port handle is not required as this driver only supports UART0. */
-	( void ) pxPort;
+	vTaskSetTimeOutState( &xTimeOut );
 
-	portENTER_CRITICAL();
+	/* The lock shares the block time.  With none, a string that arrives
+	while another task is writing is dropped like one that does not fit, so
+	vSerialPutString() never blocks and can be called with the scheduler
+	suspended, as with the queue driver. */
+	if( xSemaphoreTake( xTxLock, xBlockTime ) == pdTRUE )
 	{
-		/* Is there space to write directly to the UART? */
-		if( lTHREEmpty == ( long ) pdTRUE )
+		( void ) xTaskCheckForTimeOut( &xTimeOut, &xBlockTime );
+
+		/* One copy for the whole string.  Start the UART before waiting for
+		space, or the space would never come. */
+		xSent = xStreamBufferSend( xCharsForTx, pcData, ( size_t ) usLength, serNO_BLOCK );
+		if( ( xSent < ( size_t ) usLength ) && ( xBlockTime != serNO_BLOCK ) )
 		{
-			/* We wrote the character directly to the UART, so was 
-			successful. */
-			lTHREEmpty = pdFALSE;
-			U1THR = cOutChar;
-			xReturn = pdPASS;
+			prvStartTx();
+			xSent += xStreamBufferSend( xCharsForTx, pcData + xSent, ( size_t ) usLength - xSent, xBlockTime );
 		}
-		else 
+
+		xSemaphoreGive( xTxLock );
+	}
+
+	prvStartTx();
+
+	return xSent;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartTx( void )
+{
+unsigned char ucBurst[ serFIFO_LENGTH ];
+size_t xCount, x;
+
+	/* Once the UART is running the THRE interrupt keeps it fed. */
+	if( lTHREEmpty == ( long ) pdTRUE )
+	{
+		portENTER_CRITICAL();
 		{
-			/* We cannot write directly to the UART, so queue the character.
-			Block for a maximum of xBlockTime if there is no space in the
-			queue.  It is ok to block within a critical section as each
-			task has it's own critical section management. */
-			xReturn = xQueueSend( xCharsForTx, &cOutChar, xBlockTime );
-
-			/* Depending on queue sizing and task prioritisation:  While we 
-			were blocked waiting to post interrupts were not disabled.  It is 
-			possible that the serial ISR has emptied the Tx queue, in which
-			case we need to start the Tx off again. */
 			if( lTHREEmpty == ( long ) pdTRUE )
 			{
-				xQueueReceive( xCharsForTx, &cOutChar, serNO_BLOCK );
-				lTHREEmpty = pdFALSE;
-				U1THR = cOutChar;
+				xCount = xStreamBufferReceive( xCharsForTx, ucBurst, sizeof( ucBurst ), serNO_BLOCK );
+				if( xCount != 0U )
+				{
+					lTHREEmpty = pdFALSE;
+					for( x = 0; x < xCount; x++ )
+					{
+						U1THR = ucBurst[ x ];
+					}
+				}
 			}
 		}
+		portEXIT_CRITICAL();
 	}
-	portEXIT_CRITICAL();
-
-	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
 void vUART_ISRHandler( void )
 {
-signed char cChar;
+unsigned char ucBurst[ serFIFO_LENGTH ];
+size_t xCount, x;
 portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 unsigned char ucInterrupt;
 
@@ -257,16 +325,18 @@ unsigned char ucInterrupt;
 		switch( ucInterrupt & serINTERRUPT_SOURCE_MASK )
 		{
 			case serSOURCE_ERROR :	/* Not handling this, but clear the interrupt. */
-									cChar = U1LSR;
+									ucBurst[ 0 ] = U1LSR;
 									break;
 	
-			case serSOURCE_THRE	:	/* The THRE is empty.  If there is another
-									character in the Tx queue, send it now. */
-									if( xQueueReceiveFromISR( xCharsForTx, &cChar, &xHigherPriorityTaskWoken ) == pdTRUE )
+			case serSOURCE_THRE	:	/* The TX FIFO is empty.  Refill all of it
+									from the Tx buffer in one go. */
+									xCount = xStreamBufferReceiveFromISR( xCharsForTx, ucBurst, sizeof( ucBurst ), &xHigherPriorityTaskWoken );
+									for( x = 0; x < xCount; x++ )
 									{
-										U1THR = cChar;
+										U1THR = ucBurst[ x ];
 									}
-									else
+
+									if( xCount == 0U )
 									{
 										/* There are no further characters 
 										queued to send so we can indicate 
@@ -276,10 +346,15 @@ unsigned char ucInterrupt;
 									break;
 	
 			case serSOURCE_RX_TIMEOUT :
-			case serSOURCE_RX	:	/* A character was received.  Place it in 
-									the queue of received characters. */
-									cChar = U1RBR;
-									xQueueSendFromISR( xRxedChars, &cChar, &xHigherPriorityTaskWoken );
+			case serSOURCE_RX	:	/* Characters were received.  Empty the RX
+									FIFO and pass them on in one go; what does
+									not fit in the Rx buffer is dropped. */
+									xCount = 0;
+									while( ( xCount < sizeof( ucBurst ) ) && ( ( U1LSR & serLSR_RDR ) != 0U ) )
+									{
+										ucBurst[ xCount++ ] = U1RBR;
+									}
+									( void ) xStreamBufferSendFromISR( xRxedChars, ucBurst, xCount, &xHigherPriorityTaskWoken );
 									break;
 	
 			default				:	/* There is nothing to do, leave the ISR. */
@@ -297,10 +372,3 @@ unsigned char ucInterrupt;
 	portEXIT_SWITCHING_ISR( xHigherPriorityTaskWoken );
 }
 /*-----------------------------------------------------------*/
-
-
-
-
-
-
-	
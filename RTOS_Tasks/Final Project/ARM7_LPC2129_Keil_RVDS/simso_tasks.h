@@ -0,0 +1,39 @@
+/*
+ * Generated by Tools/simso_tasks from Simso.xml, do not edit.
+ *
+ * Periods and deadlines in ms, WCETs in us, as in the SimSo model.  The job
+ * bodies receive their row as pvParameters, see EDF/task_table.h.
+ */
+
+#ifndef SIMSO_TASKS_H
+#define SIMSO_TASKS_H
+
+#include "task_table.h"
+#include "GPIO.h"
+
+extern void vPeriodicJob( void * pvParameters );
+
+enum
+{
+	simsoTASK_T1,
+	simsoTASK_T2
+};
+
+#define simsoNUMBER_OF_TASKS	( 2 )
+
+#if ( simsoNUMBER_OF_TASKS > configEDF_MAX_PERIODIC_TASKS )
+	#error The task set needs a larger configEDF_MAX_PERIODIC_TASKS
+#endif
+
+#if ( 1 >= configMAX_PRIORITIES )
+	#error The task set needs a larger configMAX_PRIORITIES
+#endif
+
+static const PeriodicTaskConfig_t xSimsoTasks[ simsoNUMBER_OF_TASKS ] =
+{
+	/* Entry, name, stack, priority, period, deadline, WCET us, probe pin. */
+	{ vPeriodicJob, "TASK T1", 100, 1, pdMS_TO_TICKS( 5 ), pdMS_TO_TICKS( 5 ), 2300UL, ( 1UL << ( PIN3 + 0 ) ) },
+	{ vPeriodicJob, "TASK T2", 100, 1, pdMS_TO_TICKS( 20 ), pdMS_TO_TICKS( 20 ), 3000UL, ( 1UL << ( PIN3 + 1 ) ) }
+};
+
+#endif /* SIMSO_TASKS_H */
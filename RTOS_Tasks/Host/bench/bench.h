@@ -0,0 +1,31 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/*
+ * Pieces shared by the host benchmarks in this directory.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+/* Peripheral bus at the PLL output, as prvSetupHardware() in main.c sets it. */
+#define benchBUS_CLK_FULL		( ( unsigned char ) 0x01 )
+
+/* Start bit, eight data bits and one stop bit. */
+#define benchBITS_PER_BYTE		( 10UL )
+
+/* Time stamp counter on x86, nanoseconds elsewhere.  Either way the counts
+only compare code built and run on the same host. */
+static inline uint64_t ullBenchCycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( uint64_t ) xNow.tv_sec * 1000000000ULL + ( uint64_t ) xNow.tv_nsec;
+#endif
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,85 @@
+/*
+ * Host benchmark of the GPIO access layers: the GPIO.h functions against the
+ * GPIO_fast.h macros used in the tick, idle and trace hooks.
+ *
+ * Each access is repeated benchCALLS times in a loop and timed.  The empty
+ * loop is timed too: a store can overlap the loop itself on the host, so it
+ * is printed for reference rather than subtracted.  The registers are plain memory words
+ * (bench/plain_regs/lpc21xx.h), so no kernel or simulator is involved and
+ * the numbers are the cost of the access code alone: the call, the switch
+ * on port and state, and the read-modify-write GPIO_write() does on IOSET
+ * and IOCLR.  Host cycles are not ARM7 cycles, but the ratio between the
+ * two layers carries over.
+ *
+ * Build and run on the host, no FreeRTOS-Kernel needed:
+ *     make gpio_bench
+ *     build/gpio_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "GPIO.h"
+#include "GPIO_fast.h"
+
+#include "bench.h"
+
+#define benchCALLS		( 10000000UL )
+
+/* Keeps the compiler from merging or hoisting the accesses across
+iterations, without adding any instruction. */
+#define benchBARRIER()	__asm__ __volatile__( "" ::: "memory" )
+
+/* Cycles per iteration of a loop repeating xStatement. */
+#define benchTIME( pcName, xStatement )										\
+	do																		\
+	{																		\
+		uint64_t ullStart = ullBenchCycles();								\
+		unsigned long ulCall;												\
+																			\
+		for( ulCall = 0; ulCall < benchCALLS; ulCall++ )					\
+		{																	\
+			xStatement;														\
+			benchBARRIER();													\
+		}																	\
+		prvReport( ( pcName ), ullBenchCycles() - ullStart );				\
+	} while( 0 )
+
+/*-----------------------------------------------------------*/
+
+volatile unsigned long IOPIN0, IOSET0, IODIR0, IOCLR0;
+volatile unsigned long IOPIN1, IOSET1, IODIR1, IOCLR1;
+
+static volatile pinState_t xSink;
+
+static void prvReport( const char * pcName, uint64_t ullCycles );
+
+/*-----------------------------------------------------------*/
+
+static void prvReport( const char * pcName, uint64_t ullCycles )
+{
+	printf( "%-46s %6.2f cycles per call\n", pcName, ( double ) ullCycles / ( double ) benchCALLS );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	benchTIME( "empty loop", ( void ) 0 );
+
+	benchTIME( "GPIO_write(PORT_0, PIN1, PIN_IS_HIGH)", GPIO_write( PORT_0, PIN1, PIN_IS_HIGH ) );
+	benchTIME( "GPIO_FAST_SET(PORT_0, PIN1)", GPIO_FAST_SET( PORT_0, PIN1 ) );
+	benchTIME( "GPIO_write(PORT_1, PIN15, PIN_IS_LOW)", GPIO_write( PORT_1, PIN15, PIN_IS_LOW ) );
+	benchTIME( "GPIO_FAST_CLR(PORT_1, PIN15)", GPIO_FAST_CLR( PORT_1, PIN15 ) );
+	benchTIME( "GPIO_read(PORT_0, PIN0)", xSink = GPIO_read( PORT_0, PIN0 ) );
+	benchTIME( "GPIO_FAST_READ(PORT_0, PIN0)", xSink = GPIO_FAST_READ( PORT_0, PIN0 ) );
+	benchTIME( "tick pulse, 2 x GPIO_write()", { GPIO_write( PORT_0, PIN1, PIN_IS_HIGH ); GPIO_write( PORT_0, PIN1, PIN_IS_LOW ); } );
+	benchTIME( "tick pulse, GPIO_FAST_SET() + GPIO_FAST_CLR()", { GPIO_FAST_SET( PORT_0, PIN1 ); GPIO_FAST_CLR( PORT_0, PIN1 ); } );
+	benchTIME( "GPIO_writeMask(PORT_0, 3 pins, 3 pins)", GPIO_writeMask( PORT_0, GPIO_PIN_MASK( PIN1 ) | GPIO_PIN_MASK( PIN2 ) | GPIO_PIN_MASK( PIN3 ),
+			   GPIO_PIN_MASK( PIN4 ) | GPIO_PIN_MASK( PIN5 ) | GPIO_PIN_MASK( PIN6 ) ) );
+	benchTIME( "GPIO_FAST_WRITE_MASK(PORT_0, 3 pins, 3 pins)", GPIO_FAST_WRITE_MASK( PORT_0, GPIO_PIN_MASK( PIN1 ) | GPIO_PIN_MASK( PIN2 ) | GPIO_PIN_MASK( PIN3 ),
+			   GPIO_PIN_MASK( PIN4 ) | GPIO_PIN_MASK( PIN5 ) | GPIO_PIN_MASK( PIN6 ) ) );
+
+	return EXIT_SUCCESS;
+}
+/*-----------------------------------------------------------*/
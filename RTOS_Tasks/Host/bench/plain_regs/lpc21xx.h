@@ -0,0 +1,16 @@
+#ifndef LPC21XX_H
+#define LPC21XX_H
+
+/*
+ * GPIO registers as plain memory, for bench/gpio_bench.c.
+ *
+ * The registers of include/lpc21xx.h run the peripheral models on every
+ * access, which would bury the few instructions the bench compares.  Here
+ * they are ordinary volatile words defined by the bench, so only the access
+ * code is timed.  Only the GPIO registers exist.
+ */
+
+extern volatile unsigned long IOPIN0, IOSET0, IODIR0, IOCLR0;
+extern volatile unsigned long IOPIN1, IOSET1, IODIR1, IOCLR1;
+
+#endif /* LPC21XX_H */
@@ -0,0 +1,484 @@
+/*
+ * Benchmark suite for the UART1 drivers.  By default it is built against the
+ * Starter_Files_V0 driver (Starter_Files_V0/source/serial.c); built with
+ * -DbenchCOM_PORT_API=1 it drives the xComPortHandle API of serial/serial.c
+ * instead, so the queue driver in ARM7_LPC2129_Keil_RVDS/serial and the
+ * stream buffer one in the Final Project run the same scenarios.
+ *
+ * Each scenario runs at every baud rate given on the command line, 9600 and
+ * 115200 by default, for about benchLINE_SECONDS of line time:
+ *
+ *     putstring        vSerialPutString() of benchSTRING_LENGTH byte strings
+ *     putchar          xSerialPutChar() one byte at a time
+ *     putstring_paced  benchMESSAGE_LENGTH byte messages at about half the
+ *                      line rate
+ *
+ * The first two keep the transmit ring full, so they give the sustained rate,
+ * and their latency is mostly the time a byte waits behind a full ring.  They
+ * wait for room before each call, so refused calls do not count as driver
+ * time.  The paced one shows the latency the driver adds on a lightly loaded
+ * port.
+ *
+ * The simulator sends the bytes at the programmed baud rate and timestamps
+ * each one when its stop bit ends; a byte's latency runs from the start of
+ * the driver call that queued it to that moment.  vUART_ISRHandler is wrapped
+ * at link time (--wrap) to count and time the interrupts, and every driver
+ * call is timed less the interrupts taken inside it.  Cycles are the host
+ * time stamp counter, or ns where there is none: they only compare drivers
+ * built and run on the same host.
+ *
+ * The output is one JSON object per scenario and baud rate, one per line:
+ *
+ *     {"driver":"Starter_Files_V0","scenario":"putstring","baud":115200,
+ *      "bytes":...,"errors":...,"fifo_overflows":...,"bytes_per_s":...,
+ *      "line_bytes_per_s":...,"isr_per_kb":...,"task_cycles_per_byte":...,
+ *      "isr_cycles_per_byte":...,"cycles_per_byte":...,"latency_us":{"p50":...,
+ *      "p90":...,"p99":...,"p999":...,"max":...}}
+ *
+ * errors counts bytes that arrived wrong, twice or not at all, and
+ * fifo_overflows the THR writes the full TX FIFO lost; the program exits with
+ * a failure when any scenario has either.  Build with
+ * -DbenchDRIVER_NAME='"name"' to label the results of a modified driver.
+ *
+ * Build and run on the host (SIM_SPEEDUP is forced to 1 for these targets):
+ *     make FREERTOS_KERNEL=/path/to/FreeRTOS-Kernel bench
+ *     build/uart_bench [baud ...] > results.jsonl
+ *     build/uart_port_bench_queue [baud ...] >> results.jsonl
+ *     build/uart_port_bench_stream [baud ...] >> results.jsonl
+ *
+ * No results are recorded in the tree.  The suite needs a FreeRTOS-Kernel
+ * checkout to link and has not been run against one yet, so there are no
+ * figures to compare the drivers by.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Peripheral includes. */
+#include "serial.h"
+#include "sim_lpc21xx.h"
+
+#include "bench.h"
+
+#ifndef benchCOM_PORT_API
+	#define benchCOM_PORT_API		0
+#endif
+
+#ifndef benchDRIVER_NAME
+	#if ( benchCOM_PORT_API == 1 )
+		#define benchDRIVER_NAME	"serial"
+	#else
+		#define benchDRIVER_NAME	"Starter_Files_V0"
+	#endif
+#endif
+
+/* Transmit buffer of the driver.  The COM port drivers take its length at
+initialisation, the Starter_Files_V0 one has a fixed ring. */
+#if ( benchCOM_PORT_API == 1 )
+	#define benchTX_BUFFER_BYTES	( 256UL )
+#else
+	#define benchTX_BUFFER_BYTES	( ( unsigned long ) configSERIAL_TX_BUFFER_SIZE )
+#endif
+
+#define benchMAX_BAUDS			( 8 )
+#define benchLINE_SECONDS		( 1.0 )
+#define benchSTRING_LENGTH		( 64U )
+#define benchMESSAGE_LENGTH		( 32U )
+#define benchPATTERN_LENGTH		( 26U )
+
+/* Time left after the last byte for anything the driver still sends, which
+would be an error, and time without a byte after which the rest are taken as
+lost. */
+#define benchSETTLE_MS			( 20U )
+#define benchSTALL_MS			( 500U )
+
+/*-----------------------------------------------------------*/
+
+typedef struct
+{
+	const char * pcName;
+	void ( * pxRun )( void );
+	unsigned long ulChunk;			/* Bytes per driver call, the total is a multiple of it. */
+
+} BenchScenario_t;
+
+static void prvRunPutString( void );
+static void prvRunPutChar( void );
+static void prvRunPutStringPaced( void );
+
+static const BenchScenario_t xScenarios[] =
+{
+	{ "putstring", prvRunPutString, benchSTRING_LENGTH },
+	{ "putchar", prvRunPutChar, 1U },
+	{ "putstring_paced", prvRunPutStringPaced, benchMESSAGE_LENGTH }
+};
+
+/*-----------------------------------------------------------*/
+
+static unsigned long ulBauds[ benchMAX_BAUDS ] = { 9600UL, 115200UL };
+static unsigned long ulBaudCount = 2;
+
+/* The bytes sent are 'A' to 'Z' over and over, so any string of the pattern
+starts at cPattern[ sequence number % benchPATTERN_LENGTH ]. */
+static signed char cPattern[ benchPATTERN_LENGTH + benchSTRING_LENGTH ];
+
+#if ( benchCOM_PORT_API == 1 )
+	static xComPortHandle xPort;
+
+	/* The queue driver sends up to a NUL, so each string is copied here and
+	terminated before the call. */
+	static signed char cString[ benchSTRING_LENGTH + 1U ];
+#endif
+
+/* Per scenario run.  The hook fills in the latencies, the task the rest. */
+static unsigned long ulTotalBytes = 0;
+static double dLineRate = 0.0;
+static uint64_t * pullQueuedAt = NULL;
+static uint64_t * pullLatency = NULL;
+static volatile unsigned long ulQueued = 0;
+static volatile unsigned long ulBytesOut = 0;
+static volatile unsigned long ulBadBytes = 0;
+static volatile uint64_t ullLastByteAt = 0;
+static uint64_t ullTaskCycles = 0;
+
+static volatile uint64_t ullIsrCycles = 0;
+static volatile unsigned long ulIsrEntries = 0;
+
+void __real_vUART_ISRHandler( void );
+void __wrap_vUART_ISRHandler( void );
+
+static void prvTxHook( uint8_t ucByte, uint64_t ullNow );
+static void prvStamp( unsigned long ulLength );
+static signed portBASE_TYPE prvTimedPutString( unsigned long ulLength );
+static void prvWaitForWire( unsigned long ulFreeBytes );
+static int prvCompareLatency( const void * pvA, const void * pvB );
+static double prvPercentile( double dFraction );
+static int prvRunScenario( const BenchScenario_t * pxScenario, unsigned long ulBaud );
+static void prvBenchTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+void __wrap_vUART_ISRHandler( void )
+{
+uint64_t ullStart = ullBenchCycles();
+
+	__real_vUART_ISRHandler();
+
+	ullIsrCycles += ullBenchCycles() - ullStart;
+	ulIsrEntries++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTxHook( uint8_t ucByte, uint64_t ullNow )
+{
+const unsigned long ulSequence = ulBytesOut;
+
+	if( ( ulSequence < ulQueued ) && ( ucByte == ( uint8_t ) cPattern[ ulSequence % benchPATTERN_LENGTH ] ) )
+	{
+		pullLatency[ ulSequence ] = ullNow - pullQueuedAt[ ulSequence ];
+	}
+	else
+	{
+		ulBadBytes++;
+	}
+
+	ullLastByteAt = ullNow;
+	ulBytesOut = ulSequence + 1UL;
+}
+/*-----------------------------------------------------------*/
+
+/* Marks the next ulLength bytes as queued now. */
+static void prvStamp( unsigned long ulLength )
+{
+const uint64_t ullNow = ullSimNow();
+unsigned long x;
+
+	for( x = 0; x < ulLength; x++ )
+	{
+		pullQueuedAt[ ulQueued + x ] = ullNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Offers the next ulLength bytes of the pattern once, and keeps them counted
+as queued if the driver takes them. */
+static signed portBASE_TYPE prvTimedPutString( unsigned long ulLength )
+{
+const unsigned long ulFirst = ulQueued;
+signed portBASE_TYPE xTaken;
+uint64_t ullStart, ullIsrBefore;
+
+	/* Counted before the call, the first byte can reach the wire before the
+	call returns. */
+	prvStamp( ulLength );
+	ulQueued = ulFirst + ulLength;
+
+#if ( benchCOM_PORT_API == 1 )
+	memcpy( cString, &cPattern[ ulFirst % benchPATTERN_LENGTH ], ulLength );
+	cString[ ulLength ] = 0;
+
+	/* Returns nothing and drops what does not fit; every caller has made
+	room first, so the bytes are taken as queued. */
+	ullIsrBefore = ullIsrCycles;
+	ullStart = ullBenchCycles();
+	vSerialPutString( xPort, cString, ( unsigned short ) ulLength );
+	ullTaskCycles += ( ullBenchCycles() - ullStart ) - ( ullIsrCycles - ullIsrBefore );
+	xTaken = pdTRUE;
+#else
+	ullIsrBefore = ullIsrCycles;
+	ullStart = ullBenchCycles();
+	xTaken = vSerialPutString( &cPattern[ ulFirst % benchPATTERN_LENGTH ], ( unsigned short ) ulLength );
+	ullTaskCycles += ( ullBenchCycles() - ullStart ) - ( ullIsrCycles - ullIsrBefore );
+#endif
+
+	if( xTaken != pdTRUE )
+	{
+		ulQueued = ulFirst;
+	}
+
+	return xTaken;
+}
+/*-----------------------------------------------------------*/
+
+/* Waits until no more than benchTX_BUFFER_BYTES - ulFreeBytes of the queued
+bytes are still to reach the wire.  Those include the ones in the FIFO
+and in the shift register, so the ring has at least ulFreeBytes free then. */
+static void prvWaitForWire( unsigned long ulFreeBytes )
+{
+	while( ( ulQueued - ulBytesOut ) > ( benchTX_BUFFER_BYTES - ulFreeBytes ) )
+	{
+		taskYIELD();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPutString( void )
+{
+	while( ulQueued < ulTotalBytes )
+	{
+		prvWaitForWire( benchSTRING_LENGTH );
+
+		while( prvTimedPutString( benchSTRING_LENGTH ) != pdTRUE )
+		{
+			taskYIELD();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPutChar( void )
+{
+uint64_t ullStart, ullIsrBefore;
+signed portBASE_TYPE xTaken = pdPASS;
+
+	while( ulQueued < ulTotalBytes )
+	{
+		prvWaitForWire( 1UL );
+		prvStamp( 1UL );
+		ulQueued++;
+
+		ullIsrBefore = ullIsrCycles;
+		ullStart = ullBenchCycles();
+#if ( benchCOM_PORT_API == 1 )
+		xTaken = xSerialPutChar( xPort, cPattern[ ( ulQueued - 1UL ) % benchPATTERN_LENGTH ], 0 );
+#else
+		xSerialPutChar( cPattern[ ( ulQueued - 1UL ) % benchPATTERN_LENGTH ] );
+#endif
+		ullTaskCycles += ( ullBenchCycles() - ullStart ) - ( ullIsrCycles - ullIsrBefore );
+
+		if( xTaken != pdPASS )
+		{
+			/* There is room, so this cannot happen.  Counted, then sent
+			again so that the byte sequence stays whole. */
+			ulQueued--;
+			ulBadBytes++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPutStringPaced( void )
+{
+TickType_t xLastWake = xTaskGetTickCount();
+TickType_t xPeriod;
+
+	/* Twice the line time of one message, rounded up to whole ticks. */
+	xPeriod = ( TickType_t ) ( ( 2.0 * benchMESSAGE_LENGTH * ( double ) configTICK_RATE_HZ ) / dLineRate ) + 1U;
+
+	while( ulQueued < ulTotalBytes )
+	{
+		vTaskDelayUntil( &xLastWake, xPeriod );
+
+		if( prvTimedPutString( benchMESSAGE_LENGTH ) != pdTRUE )
+		{
+			/* Cannot happen at this rate.  Counted, then sent in the next
+			period so that the byte sequence stays whole. */
+			ulBadBytes += benchMESSAGE_LENGTH;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareLatency( const void * pvA, const void * pvB )
+{
+const uint64_t ullA = *( const uint64_t * ) pvA, ullB = *( const uint64_t * ) pvB;
+
+	return ( ullA > ullB ) - ( ullA < ullB );
+}
+/*-----------------------------------------------------------*/
+
+/* Nearest rank percentile of the sorted latencies, in us. */
+static double prvPercentile( double dFraction )
+{
+unsigned long ulRank = ( unsigned long ) ( dFraction * ( double ) ulTotalBytes + 0.999999 );
+
+	if( ulRank == 0UL )
+	{
+		ulRank = 1UL;
+	}
+	if( ulRank > ulTotalBytes )
+	{
+		ulRank = ulTotalBytes;
+	}
+
+	return ( double ) pullLatency[ ulRank - 1UL ] / 1e3;
+}
+/*-----------------------------------------------------------*/
+
+static int prvRunScenario( const BenchScenario_t * pxScenario, unsigned long ulBaud )
+{
+uint64_t ullStart, ullElapsed;
+unsigned long ulErrors, ulSeen, ulOverflows;
+TickType_t xLastProgress;
+SimStats_t xBefore, xAfter;
+
+	/* The rate the divisor programmed by xSerialPortInitMinimal() gives,
+	which is not exactly the one asked for. */
+	dLineRate = ( double ) configCPU_CLOCK_HZ / ( double ) ( 16UL * ( configCPU_CLOCK_HZ / ( ulBaud * 16UL ) ) ) / ( double ) benchBITS_PER_BYTE;
+
+	ulTotalBytes = ( unsigned long ) ( dLineRate * benchLINE_SECONDS ) / pxScenario->ulChunk * pxScenario->ulChunk;
+	pullQueuedAt = malloc( ulTotalBytes * sizeof( uint64_t ) );
+	pullLatency = calloc( ulTotalBytes, sizeof( uint64_t ) );
+	if( ( pullQueuedAt == NULL ) || ( pullLatency == NULL ) )
+	{
+		exit( EXIT_FAILURE );
+	}
+
+	/* The port is idle here, so changing the rate loses nothing.  The COM
+	port drivers allocate new buffers each time and the old ones are left
+	behind, which the host can afford. */
+#if ( benchCOM_PORT_API == 1 )
+	xPort = xSerialPortInitMinimal( ulBaud, benchTX_BUFFER_BYTES );
+	if( xPort == ( xComPortHandle ) 0 )
+	{
+		exit( EXIT_FAILURE );
+	}
+#else
+	xSerialPortInitMinimal( ulBaud );
+#endif
+
+	ulQueued = 0;
+	ulBytesOut = 0;
+	ulBadBytes = 0;
+	ullTaskCycles = 0;
+	ullIsrCycles = 0;
+	ulIsrEntries = 0;
+	vSimGetStats( &xBefore );
+	ullStart = xBefore.ullNow;
+
+	pxScenario->pxRun();
+
+	ulSeen = ulBytesOut;
+	xLastProgress = xTaskGetTickCount();
+	while( ( ulBytesOut < ulTotalBytes ) && ( ( xTaskGetTickCount() - xLastProgress ) < pdMS_TO_TICKS( benchSTALL_MS ) ) )
+	{
+		vTaskDelay( 1 );
+
+		if( ulBytesOut != ulSeen )
+		{
+			ulSeen = ulBytesOut;
+			xLastProgress = xTaskGetTickCount();
+		}
+	}
+	ullElapsed = ullLastByteAt - ullStart;
+	vTaskDelay( pdMS_TO_TICKS( benchSETTLE_MS ) );
+	vSimGetStats( &xAfter );
+	ulOverflows = ( unsigned long ) ( xAfter.ullUartTxFifoOverflows - xBefore.ullUartTxFifoOverflows );
+
+	/* The hook counts wrong and extra bytes, missing ones are counted here. */
+	ulErrors = ulBadBytes + ( ( ulBytesOut < ulTotalBytes ) ? ( ulTotalBytes - ulBytesOut ) : 0UL );
+
+	qsort( pullLatency, ulTotalBytes, sizeof( uint64_t ), prvCompareLatency );
+
+	printf( "{\"driver\":\"%s\",\"scenario\":\"%s\",\"baud\":%lu,\"bytes\":%lu,\"errors\":%lu,\"fifo_overflows\":%lu,", benchDRIVER_NAME,
+			pxScenario->pcName, ulBaud, ulTotalBytes, ulErrors, ulOverflows );
+	printf( "\"bytes_per_s\":%.1f,\"line_bytes_per_s\":%.1f,\"isr_per_kb\":%.2f,", ( double ) ulTotalBytes * 1e9 / ( double ) ullElapsed,
+			dLineRate, ( double ) ulIsrEntries * 1024.0 / ( double ) ulTotalBytes );
+	printf( "\"task_cycles_per_byte\":%.1f,\"isr_cycles_per_byte\":%.1f,\"cycles_per_byte\":%.1f,", ( double ) ullTaskCycles / ( double ) ulTotalBytes,
+			( double ) ullIsrCycles / ( double ) ulTotalBytes, ( double ) ( ullTaskCycles + ullIsrCycles ) / ( double ) ulTotalBytes );
+	printf( "\"latency_us\":{\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}}\n", prvPercentile( 0.50 ), prvPercentile( 0.90 ),
+			prvPercentile( 0.99 ), prvPercentile( 0.999 ), prvPercentile( 1.0 ) );
+	fflush( stdout );
+
+	/* From here on the hook takes any byte as an extra one. */
+	ulQueued = 0;
+	free( pullQueuedAt );
+	free( pullLatency );
+
+	return ( ( ulErrors == 0UL ) && ( ulOverflows == 0UL ) ) ? 0 : 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchTask( void * pvParameters )
+{
+unsigned long ulBaud, ulScenario;
+int iFailures = 0;
+
+	( void ) pvParameters;
+
+	for( ulBaud = 0; ulBaud < ulBaudCount; ulBaud++ )
+	{
+		for( ulScenario = 0; ulScenario < ( sizeof( xScenarios ) / sizeof( xScenarios[ 0 ] ) ); ulScenario++ )
+		{
+			iFailures += prvRunScenario( &xScenarios[ ulScenario ], ulBauds[ ulBaud ] );
+		}
+	}
+
+	exit( ( iFailures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char * argv[] )
+{
+unsigned long x;
+int i;
+
+	if( argc > 1 )
+	{
+		ulBaudCount = 0;
+		for( i = 1; ( i < argc ) && ( ulBaudCount < benchMAX_BAUDS ); i++ )
+		{
+			ulBauds[ ulBaudCount++ ] = strtoul( argv[ i ], NULL, 10 );
+		}
+	}
+
+	for( x = 0; x < ( unsigned long ) sizeof( cPattern ); x++ )
+	{
+		cPattern[ x ] = ( signed char ) ( 'A' + ( x % benchPATTERN_LENGTH ) );
+	}
+
+	VPBDIV = benchBUS_CLK_FULL;
+	vSimSetUartTxHook( prvTxHook );
+
+	xTaskCreate( prvBenchTask, "Bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
+/*-----------------------------------------------------------*/
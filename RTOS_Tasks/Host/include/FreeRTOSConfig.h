@@ -0,0 +1,46 @@
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+/*
+ * Host build configuration: the Final Project configuration, trace hooks
+ * included, with the settings the FreeRTOS POSIX port needs on top.  The IPC
+ * demos use it too, so all programs share one set of hooks and defaults.
+ */
+
+#include <assert.h>
+
+#include "../../Final Project/ARM7_LPC2129_Keil_RVDS/FreeRTOSConfig.h"
+#include "sim_lpc21xx.h"
+
+/* The port's tick timer runs SIM_SPEEDUP times faster than 1 kHz, so one tick
+is still one simulated millisecond, and pdMS_TO_TICKS keeps its meaning. */
+#undef configTICK_RATE_HZ
+#define configTICK_RATE_HZ			( ( TickType_t ) ( 1000 * SIM_SPEEDUP ) )
+#define pdMS_TO_TICKS( xTimeInMs )	( ( TickType_t ) ( xTimeInMs ) )
+
+/* Task stacks are host thread stacks.  The port falls back to a default
+size when the requested one is too small, so only the kernel's own tasks
+need the larger value. */
+#undef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE	( ( unsigned short ) 4096 )
+
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE		( ( size_t ) 1024 * 1024 )
+
+#undef configMAX_TASK_NAME_LEN
+#define configMAX_TASK_NAME_LEN		( 16 )
+
+#define configASSERT( x )			assert( x )
+
+/* The upstream kernel has no EDF scheduler: periodic tasks are created as
+fixed priority tasks and released by vTaskDelayUntil like on the board. */
+#undef configUSE_EDF_SCHEDULER
+#define configUSE_EDF_SCHEDULER		0
+
+/* serial.c ends its handler with the ARM7 port's macro. */
+#define portEXIT_SWITCHING_ISR( xSwitchRequired )	portYIELD_FROM_ISR( xSwitchRequired )
+
+#define xTaskPeriodicCreate( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, xPeriod ) \
+	xTaskCreate( ( pxTaskCode ), ( pcName ), ( usStackDepth ), ( pvParameters ), ( uxPriority ), ( pxCreatedTask ) )
+
+#endif /* HOST_FREERTOS_CONFIG_H */
@@ -0,0 +1,240 @@
+#ifndef LPC21XX_H
+#define LPC21XX_H
+
+/*
+ * Simulated LPC21xx register block for the host build (see Host/Makefile).
+ *
+ * Every register name expands to an lvalue returned by pulSimRegister(), so
+ * the firmware sources compile unchanged and each access runs the peripheral
+ * models in sim/sim_lpc21xx.c first.  The access classes are:
+ *
+ *  - plain registers (IODIR, U1IER, U1LCR, T1PR, VICIntEnable, ...) are
+ *    ordinary storage; the models react to new values on the next access.
+ *  - write only registers (IOSET, IOCLR, U1THR, U1FCR, VICIntEnClr) return a
+ *    fresh write slot per access, so every store is applied exactly once and
+ *    in order, including read-modify-write forms such as SET_BIT( IOSET0, n ).
+ *  - read registers with side effects or computed values (IOPIN, U1RBR,
+ *    U1IIR, U1LSR, T1TC, VICIRQStatus) return a snapshot taken at the access;
+ *    stores to them are ignored.
+ *
+ * Only the peripherals used by the firmware are modelled: GPIO ports 0/1,
+ * UART1, the Timer1 counter and the vectored IRQ part of the VIC.  The rest
+ * of the names exist so that code touching them still compiles.
+ */
+
+/************* Type def section ************/
+
+typedef enum
+{
+	/* System control. */
+	simVPBDIV,
+	simMAMCR,
+	simMAMTIM,
+	simPLLCON,
+	simPLLCFG,
+	simPLLSTAT,
+	simPLLFEED,
+	simPINSEL0,
+	simPINSEL1,
+	simPINSEL2,
+
+	/* GPIO. */
+	simIOPIN0,
+	simIOSET0,
+	simIODIR0,
+	simIOCLR0,
+	simIOPIN1,
+	simIOSET1,
+	simIODIR1,
+	simIOCLR1,
+
+	/* UART0, storage only. */
+	simU0RBR,
+	simU0THR,
+	simU0DLL,
+	simU0DLM,
+	simU0IER,
+	simU0IIR,
+	simU0FCR,
+	simU0LCR,
+	simU0LSR,
+	simU0SCR,
+
+	/* UART1. */
+	simU1RBR,
+	simU1THR,
+	simU1DLL,
+	simU1DLM,
+	simU1IER,
+	simU1IIR,
+	simU1FCR,
+	simU1LCR,
+	simU1MCR,
+	simU1LSR,
+	simU1MSR,
+	simU1SCR,
+
+	/* Timer0, storage only: the host tick comes from the POSIX port. */
+	simT0IR,
+	simT0TCR,
+	simT0TC,
+	simT0PR,
+	simT0PC,
+	simT0MCR,
+	simT0MR0,
+	simT0MR1,
+	simT0MR2,
+	simT0MR3,
+
+	/* Timer1, counter only. */
+	simT1IR,
+	simT1TCR,
+	simT1TC,
+	simT1PR,
+	simT1PC,
+	simT1MCR,
+	simT1MR0,
+	simT1MR1,
+	simT1MR2,
+	simT1MR3,
+
+	/* VIC. */
+	simVICIRQStatus,
+	simVICFIQStatus,
+	simVICRawIntr,
+	simVICIntSelect,
+	simVICIntEnable,
+	simVICIntEnClr,
+	simVICSoftInt,
+	simVICSoftIntClear,
+	simVICProtection,
+	simVICVectAddr,
+	simVICDefVectAddr,
+	simVICVectAddr0,
+	simVICVectAddr15 = simVICVectAddr0 + 15,
+	simVICVectCntl0,
+	simVICVectCntl15 = simVICVectCntl0 + 15,
+
+	simNUMBER_OF_REGISTERS
+
+} SimRegister_t;
+
+/************ Function declaration section ***********/
+
+extern volatile unsigned long * pulSimRegister( SimRegister_t eRegister );
+
+/*-----------------------------------------------------------*/
+
+#define simREG( eRegister )		( *pulSimRegister( eRegister ) )
+
+#define VPBDIV			simREG( simVPBDIV )
+#define MAMCR			simREG( simMAMCR )
+#define MAMTIM			simREG( simMAMTIM )
+#define PLLCON			simREG( simPLLCON )
+#define PLLCFG			simREG( simPLLCFG )
+#define PLLSTAT			simREG( simPLLSTAT )
+#define PLLFEED			simREG( simPLLFEED )
+#define PINSEL0			simREG( simPINSEL0 )
+#define PINSEL1			simREG( simPINSEL1 )
+#define PINSEL2			simREG( simPINSEL2 )
+
+#define IOPIN0			simREG( simIOPIN0 )
+#define IOSET0			simREG( simIOSET0 )
+#define IODIR0			simREG( simIODIR0 )
+#define IOCLR0			simREG( simIOCLR0 )
+#define IOPIN1			simREG( simIOPIN1 )
+#define IOSET1			simREG( simIOSET1 )
+#define IODIR1			simREG( simIODIR1 )
+#define IOCLR1			simREG( simIOCLR1 )
+
+#define U0RBR			simREG( simU0RBR )
+#define U0THR			simREG( simU0THR )
+#define U0DLL			simREG( simU0DLL )
+#define U0DLM			simREG( simU0DLM )
+#define U0IER			simREG( simU0IER )
+#define U0IIR			simREG( simU0IIR )
+#define U0FCR			simREG( simU0FCR )
+#define U0LCR			simREG( simU0LCR )
+#define U0LSR			simREG( simU0LSR )
+#define U0SCR			simREG( simU0SCR )
+
+#define U1RBR			simREG( simU1RBR )
+#define U1THR			simREG( simU1THR )
+#define U1DLL			simREG( simU1DLL )
+#define U1DLM			simREG( simU1DLM )
+#define U1IER			simREG( simU1IER )
+#define U1IIR			simREG( simU1IIR )
+#define U1FCR			simREG( simU1FCR )
+#define U1LCR			simREG( simU1LCR )
+#define U1MCR			simREG( simU1MCR )
+#define U1LSR			simREG( simU1LSR )
+#define U1MSR			simREG( simU1MSR )
+#define U1SCR			simREG( simU1SCR )
+
+#define T0IR			simREG( simT0IR )
+#define T0TCR			simREG( simT0TCR )
+#define T0TC			simREG( simT0TC )
+#define T0PR			simREG( simT0PR )
+#define T0PC			simREG( simT0PC )
+#define T0MCR			simREG( simT0MCR )
+#define T0MR0			simREG( simT0MR0 )
+#define T0MR1			simREG( simT0MR1 )
+#define T0MR2			simREG( simT0MR2 )
+#define T0MR3			simREG( simT0MR3 )
+
+#define T1IR			simREG( simT1IR )
+#define T1TCR			simREG( simT1TCR )
+#define T1TC			simREG( simT1TC )
+#define T1PR			simREG( simT1PR )
+#define T1PC			simREG( simT1PC )
+#define T1MCR			simREG( simT1MCR )
+#define T1MR0			simREG( simT1MR0 )
+#define T1MR1			simREG( simT1MR1 )
+#define T1MR2			simREG( simT1MR2 )
+#define T1MR3			simREG( simT1MR3 )
+
+#define VICIRQStatus	simREG( simVICIRQStatus )
+#define VICFIQStatus	simREG( simVICFIQStatus )
+#define VICRawIntr		simREG( simVICRawIntr )
+#define VICIntSelect	simREG( simVICIntSelect )
+#define VICIntEnable	simREG( simVICIntEnable )
+#define VICIntEnClr		simREG( simVICIntEnClr )
+#define VICSoftInt		simREG( simVICSoftInt )
+#define VICSoftIntClear	simREG( simVICSoftIntClear )
+#define VICProtection	simREG( simVICProtection )
+#define VICVectAddr		simREG( simVICVectAddr )
+#define VICDefVectAddr	simREG( simVICDefVectAddr )
+#define VICVectAddr0	simREG( simVICVectAddr0 + 0 )
+#define VICVectAddr1	simREG( simVICVectAddr0 + 1 )
+#define VICVectAddr2	simREG( simVICVectAddr0 + 2 )
+#define VICVectAddr3	simREG( simVICVectAddr0 + 3 )
+#define VICVectAddr4	simREG( simVICVectAddr0 + 4 )
+#define VICVectAddr5	simREG( simVICVectAddr0 + 5 )
+#define VICVectAddr6	simREG( simVICVectAddr0 + 6 )
+#define VICVectAddr7	simREG( simVICVectAddr0 + 7 )
+#define VICVectAddr8	simREG( simVICVectAddr0 + 8 )
+#define VICVectAddr9	simREG( simVICVectAddr0 + 9 )
+#define VICVectAddr10	simREG( simVICVectAddr0 + 10 )
+#define VICVectAddr11	simREG( simVICVectAddr0 + 11 )
+#define VICVectAddr12	simREG( simVICVectAddr0 + 12 )
+#define VICVectAddr13	simREG( simVICVectAddr0 + 13 )
+#define VICVectAddr14	simREG( simVICVectAddr0 + 14 )
+#define VICVectAddr15	simREG( simVICVectAddr0 + 15 )
+#define VICVectCntl0	simREG( simVICVectCntl0 + 0 )
+#define VICVectCntl1	simREG( simVICVectCntl0 + 1 )
+#define VICVectCntl2	simREG( simVICVectCntl0 + 2 )
+#define VICVectCntl3	simREG( simVICVectCntl0 + 3 )
+#define VICVectCntl4	simREG( simVICVectCntl0 + 4 )
+#define VICVectCntl5	simREG( simVICVectCntl0 + 5 )
+#define VICVectCntl6	simREG( simVICVectCntl0 + 6 )
+#define VICVectCntl7	simREG( simVICVectCntl0 + 7 )
+#define VICVectCntl8	simREG( simVICVectCntl0 + 8 )
+#define VICVectCntl9	simREG( simVICVectCntl0 + 9 )
+#define VICVectCntl10	simREG( simVICVectCntl0 + 10 )
+#define VICVectCntl11	simREG( simVICVectCntl0 + 11 )
+#define VICVectCntl12	simREG( simVICVectCntl0 + 12 )
+#define VICVectCntl13	simREG( simVICVectCntl0 + 13 )
+#define VICVectCntl14	simREG( simVICVectCntl0 + 14 )
+#define VICVectCntl15	simREG( simVICVectCntl0 + 15 )
+
+#endif /* LPC21XX_H */
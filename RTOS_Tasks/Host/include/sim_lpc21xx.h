@@ -0,0 +1,69 @@
+#ifndef SIM_LPC21XX_H
+#define SIM_LPC21XX_H
+
+/*
+ * Host side interface of the simulated LPC21xx peripherals.
+ *
+ * Simulated time starts when the program starts and runs SIM_SPEEDUP times
+ * faster than the wall clock.  The FreeRTOS tick, Timer1 and the UART bit
+ * timing all follow it, so a program behaves as on the board, only faster.
+ * Peripheral interrupts are delivered to the running FreeRTOS thread with
+ * simIRQ_SIGNAL, which the POSIX port blocks inside critical sections like
+ * any other signal, so they behave like IRQs masked by the CPSR I bit.
+ *
+ * Firmware code never uses this header; it is for the simulator itself and
+ * for host benchmarks and tests that drive inputs or read statistics.
+ */
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lpc21xx.h"
+
+#ifndef SIM_SPEEDUP
+	#define SIM_SPEEDUP			10
+#endif
+
+#define simIRQ_SIGNAL			( SIGRTMIN + 2 )
+
+#define simVIC_CHANNELS			( 32 )
+#define simVIC_UART1_CHANNEL	( 7 )
+
+/************* Type def section ************/
+
+typedef struct
+{
+	uint64_t ullNow;							/* Simulated ns when the statistics were taken. */
+	uint64_t ullUartTxBytes;					/* Bytes that left the UART1 TXD shift register. */
+	uint64_t ullUartRxBytes;					/* Bytes that arrived on UART1 RXD. */
+	uint64_t ullUartRxOverruns;					/* Bytes lost because the RX FIFO was full. */
+	uint64_t ullUartTxFifoOverflows;			/* THR writes lost because the TX FIFO was full. */
+	uint64_t ullIsrEntries[ simVIC_CHANNELS ];	/* Handler calls per VIC channel. */
+	uint64_t ullDroppedWrites;					/* Write slots reclaimed before they were stored. */
+
+} SimStats_t;
+
+/* Called for every byte that leaves TXD, at the simulated time its stop bit ends. */
+typedef void ( * SimUartTxHook_t )( uint8_t ucByte, uint64_t ullNow );
+
+/************ Function declaration section ***********/
+
+/* Simulated nanoseconds since the start of the program. */
+extern uint64_t ullSimNow( void );
+
+/* Sets the level seen on the input pins in ulMask of port ulPort (0 or 1). */
+extern void vSimSetInputs( unsigned long ulPort, uint32_t ulMask, uint32_t ulLevels );
+
+/* Queues bytes that arrive on UART1 RXD back to back at the programmed baud rate. */
+extern void vSimUartReceive( const uint8_t * pucData, size_t xLength );
+
+/* Replaces the default TXD sink (SIM_UART1_TX, or stdout). */
+extern void vSimSetUartTxHook( SimUartTxHook_t pxHook );
+
+extern void vSimGetStats( SimStats_t * pxStats );
+
+/* Prints the statistics to stderr. */
+extern void vSimReport( void );
+
+#endif /* SIM_LPC21XX_H */
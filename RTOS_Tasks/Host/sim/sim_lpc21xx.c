@@ -0,0 +1,1250 @@
+/*
+ * Simulated LPC21xx peripherals for the host build.
+ *
+ * All peripheral state is advanced lazily to the current simulated time on
+ * every register access, under xSimLock with all signals blocked, so an
+ * interrupt handler running on the same thread can never find it locked.
+ * A helper thread sleeps until the next timed event (a byte finishing on
+ * TXD, a byte arriving on RXD, a THRE or character timeout interrupt),
+ * advances the models and raises simIRQ_SIGNAL when the VIC has an enabled
+ * request pending.  The signal handler plays the role of the IRQ exception:
+ * it calls the vectored handlers found in VICVectAddrN until nothing is
+ * pending.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Scheduler includes, for configCPU_CLOCK_HZ. */
+#include "FreeRTOS.h"
+
+#include "lpc21xx.h"
+#include "sim_lpc21xx.h"
+
+#if ( ULONG_MAX <= 0xffffffffUL )
+	#error The simulated registers need a 64 bit unsigned long
+#endif
+
+/*-----------------------------------------------------------*/
+
+#define simNS_PER_S					( 1000000000ULL )
+#define simNEVER					( UINT64_MAX )
+
+/* Outstanding stores to write only registers.  A slot is applied once it no
+longer holds simWRITE_SENTINEL; the low half of the sentinel is 0, so
+read-modify-write forms act on 0 like the hardware read-back of IOSET. */
+#define simWRITE_SLOTS				( 256U )
+#define simWRITE_SENTINEL			( 0x5a5a5a5a00000000UL )
+#define simREAD_SLOTS				( 256U )
+
+/* Longest real time the helper thread sleeps, to pick up SIM_RUN_MS. */
+#define simPOLL_REAL_NS				( 1000000ULL )
+#define simIRQ_RETRY_REAL_NS		( 20000ULL )
+
+/* A handler that leaves its source pending is retried on the next event. */
+#define simMAX_DISPATCH_LOOPS		( 16 )
+
+#define simUART_FIFO_LENGTH			( 16U )
+
+/* UART register bits. */
+#define simIER_RBR					( 0x01UL )
+#define simIER_THRE					( 0x02UL )
+#define simIER_RLS					( 0x04UL )
+#define simIIR_NO_INTERRUPT			( 0x01UL )
+#define simIIR_RLS					( 0x06UL )
+#define simIIR_RDA					( 0x04UL )
+#define simIIR_CTI					( 0x0cUL )
+#define simIIR_THRE					( 0x02UL )
+#define simIIR_FIFOS_ENABLED		( 0xc0UL )
+#define simFCR_FIFO_ENABLE			( 0x01UL )
+#define simFCR_RX_RESET				( 0x02UL )
+#define simFCR_TX_RESET				( 0x04UL )
+#define simLCR_DLAB					( 0x80UL )
+#define simLSR_RDR					( 0x01UL )
+#define simLSR_OE					( 0x02UL )
+#define simLSR_THRE					( 0x20UL )
+#define simLSR_TEMT					( 0x40UL )
+
+/* Timer register bits. */
+#define simTCR_ENABLE				( 0x01UL )
+#define simTCR_RESET				( 0x02UL )
+
+/* VIC register bits. */
+#define simVECTCNTL_ENABLE			( 0x20UL )
+#define simVECTCNTL_CHANNEL_MASK	( 0x1fUL )
+
+/*-----------------------------------------------------------*/
+
+typedef struct
+{
+	volatile unsigned long ulValue;
+	SimRegister_t eRegister;
+	uint8_t ucUsed;
+
+} SimWriteSlot_t;
+
+typedef struct
+{
+	uint8_t ucTx[ simUART_FIFO_LENGTH ];
+	uint8_t ucRx[ simUART_FIFO_LENGTH ];
+	unsigned uTxHead, uTxCount;
+	unsigned uRxHead, uRxCount;
+	unsigned uRxTrigger;
+
+	uint8_t ucShiftByte;
+	uint8_t xShifting;
+	uint64_t ullShiftEnd;
+
+	/* THRE interrupt: the LPC2000 UART delays it by one character minus the
+	stop bit unless at least two bytes were written since the last one. */
+	uint8_t xThrePending;
+	unsigned uWrittenSinceThre;
+	uint64_t ullThreAt;
+
+	uint64_t ullRxNextArrival;
+	uint64_t ullRxLastActivity;
+	uint8_t xTimeoutPending;
+
+	unsigned long ulLsrErrors;
+	unsigned long ulLastIer;
+	uint64_t ullLastCharTime;
+
+	/* Bytes queued by the host for RXD. */
+	uint8_t * pucHostRx;
+	size_t xHostRxLength, xHostRxNext, xHostRxSize;
+
+} SimUart_t;
+
+typedef struct
+{
+	unsigned long ulTcr, ulPr, ulVpbdiv;	/* Settings the current base was taken with. */
+	uint32_t ulBase;						/* TC at ullBaseTime. */
+	uint64_t ullBaseTime;
+
+} SimTimer_t;
+
+typedef struct
+{
+	uint64_t ullTime;
+	unsigned long ulPort;
+	uint32_t ulMask;
+	uint32_t ulLevel;
+
+} SimGpioEvent_t;
+
+/*-----------------------------------------------------------*/
+
+static pthread_mutex_t xSimLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xEventChanged;
+static atomic_bool xIrqRaised;
+static atomic_uint_fast64_t ullNextEvent = simNEVER;
+
+static struct timespec xStartTime;
+
+static unsigned long ulRegisters[ simNUMBER_OF_REGISTERS ];
+
+static SimWriteSlot_t xWriteSlots[ simWRITE_SLOTS ];
+static uint32_t ulWriteHead = 0, ulWriteTail = 0;
+
+static volatile unsigned long ulReadSlots[ simREAD_SLOTS ];
+static uint32_t ulReadNext = 0;
+
+static uint32_t ulOutputLatch[ 2 ];
+static uint32_t ulInputLevel[ 2 ];
+static uint32_t ulLastPins[ 2 ];
+
+static SimGpioEvent_t * pxGpioScript = NULL;
+static size_t xGpioScriptLength = 0, xGpioScriptNext = 0;
+
+static SimTimer_t xTimer1;
+static SimUart_t xUart1;
+static SimStats_t xStats;
+
+static int iTxFd = STDOUT_FILENO;
+static FILE * pxVcd = NULL;
+static SimUartTxHook_t pxTxHook = NULL;
+static uint64_t ullRunLimit = simNEVER;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void );
+static void prvLock( sigset_t * pxPrevious );
+static void prvUnlock( const sigset_t * pxPrevious );
+static void prvAdvance( uint64_t ullNow );
+static void prvCommitWrites( uint64_t ullNow );
+static void prvApplyWrite( SimRegister_t eRegister, unsigned long ulValue, uint64_t ullNow );
+static unsigned long prvRead( SimRegister_t eRegister, uint64_t ullNow );
+static uint32_t prvPins( unsigned long ulPort );
+static void prvGpioAdvance( uint64_t ullNow );
+static uint32_t prvPclk( unsigned long ulVpbdiv );
+static uint32_t prvTimer1Count( uint64_t ullNow );
+static void prvTimer1Advance( uint64_t ullNow );
+static uint64_t prvUartCharTime( void );
+static void prvUartAdvance( uint64_t ullNow );
+static void prvUartStartShift( uint64_t ullNow );
+static unsigned long prvUartIir( uint64_t ullNow );
+static uint32_t prvVicPending( uint64_t ullNow );
+static uint32_t prvIrqStatus( uint64_t ullNow );
+static void prvUpdateNextEvent( uint64_t ullNow );
+static void prvRaiseIrq( uint32_t ulStatus );
+static void prvIrqHandler( int iSignal );
+static void * prvEventThread( void * pvParameters );
+static void prvLoadRxFile( const char * pcPath );
+static void prvLoadGpioScript( const char * pcPath );
+static void prvVcdOpen( const char * pcPath );
+static void prvVcdWrite( uint64_t ullNow );
+
+/*-----------------------------------------------------------*/
+
+__attribute__( ( constructor ) ) static void prvSimInit( void )
+{
+struct sigaction xAction;
+sigset_t xIrq;
+pthread_t xThread;
+pthread_condattr_t xCondAttr;
+const char * pcValue;
+
+	clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+
+	pthread_condattr_init( &xCondAttr );
+	pthread_condattr_setclock( &xCondAttr, CLOCK_MONOTONIC );
+	pthread_cond_init( &xEventChanged, &xCondAttr );
+	pthread_condattr_destroy( &xCondAttr );
+
+	/* Reset values that differ from 0.  VPBDIV stays 0 (PCLK = CCLK / 4)
+	until the firmware changes it, as on the board. */
+	ulRegisters[ simU1LSR ] = simLSR_THRE | simLSR_TEMT;
+	xUart1.uRxTrigger = 1;
+	xUart1.ullThreAt = simNEVER;
+	xUart1.ullLastCharTime = simNEVER;
+
+	if( ( pcValue = getenv( "SIM_UART1_TX" ) ) != NULL )
+	{
+		iTxFd = open( pcValue, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+		if( iTxFd < 0 )
+		{
+			perror( pcValue );
+			exit( 1 );
+		}
+	}
+	if( ( pcValue = getenv( "SIM_UART1_RX" ) ) != NULL )
+	{
+		prvLoadRxFile( pcValue );
+	}
+	if( ( pcValue = getenv( "SIM_GPIO_SCRIPT" ) ) != NULL )
+	{
+		prvLoadGpioScript( pcValue );
+	}
+	if( ( pcValue = getenv( "SIM_GPIO_VCD" ) ) != NULL )
+	{
+		prvVcdOpen( pcValue );
+	}
+	if( ( pcValue = getenv( "SIM_RUN_MS" ) ) != NULL )
+	{
+		ullRunLimit = strtoull( pcValue, NULL, 10 ) * 1000000ULL;
+	}
+
+	/* The handler runs with every signal blocked, like an IRQ with the I bit
+	set, so the tick cannot preempt it. */
+	memset( &xAction, 0, sizeof( xAction ) );
+	xAction.sa_handler = prvIrqHandler;
+	xAction.sa_flags = SA_RESTART;
+	sigfillset( &xAction.sa_mask );
+	sigaction( simIRQ_SIGNAL, &xAction, NULL );
+
+	/* main() runs with the IRQ masked until the scheduler starts; the POSIX
+	port unblocks all signals for a task when it enables interrupts.  The
+	event thread inherits the mask and never takes the signal. */
+	sigemptyset( &xIrq );
+	sigaddset( &xIrq, simIRQ_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xIrq, NULL );
+
+	if( pthread_create( &xThread, NULL, prvEventThread, NULL ) != 0 )
+	{
+		perror( "sim event thread" );
+		exit( 1 );
+	}
+	pthread_detach( xThread );
+}
+/*-----------------------------------------------------------*/
+
+volatile unsigned long * pulSimRegister( SimRegister_t eRegister )
+{
+volatile unsigned long * pulRegister;
+sigset_t xPrevious;
+uint64_t ullNow;
+uint32_t ulStatus;
+
+	prvLock( &xPrevious );
+	ullNow = prvNow();
+	prvAdvance( ullNow );
+
+	switch( eRegister )
+	{
+		case simIOSET0:
+		case simIOCLR0:
+		case simIOSET1:
+		case simIOCLR1:
+		case simU1THR:
+		case simU1FCR:
+		case simVICIntEnClr:
+		case simVICSoftIntClear:
+		{
+			SimWriteSlot_t * pxSlot;
+
+			/* Reclaim the oldest slot if a store never came. */
+			if( ( ulWriteHead - ulWriteTail ) >= simWRITE_SLOTS )
+			{
+				xWriteSlots[ ulWriteTail % simWRITE_SLOTS ].ucUsed = 0;
+				ulWriteTail++;
+				xStats.ullDroppedWrites++;
+			}
+
+			pxSlot = &xWriteSlots[ ulWriteHead % simWRITE_SLOTS ];
+			ulWriteHead++;
+			pxSlot->eRegister = eRegister;
+			pxSlot->ulValue = simWRITE_SENTINEL;
+			pxSlot->ucUsed = 1;
+			pulRegister = &pxSlot->ulValue;
+			break;
+		}
+
+		case simIOPIN0:
+		case simIOPIN1:
+		case simU1RBR:
+		case simU1IIR:
+		case simU1LSR:
+		case simT1TC:
+		case simVICIRQStatus:
+		case simVICRawIntr:
+		{
+			volatile unsigned long * pulSnapshot = &ulReadSlots[ ulReadNext++ % simREAD_SLOTS ];
+
+			*pulSnapshot = prvRead( eRegister, ullNow );
+			pulRegister = pulSnapshot;
+			break;
+		}
+
+		default:
+			pulRegister = ( volatile unsigned long * ) &ulRegisters[ eRegister ];
+			break;
+	}
+
+	prvUpdateNextEvent( ullNow );
+	ulStatus = prvIrqStatus( ullNow );
+	prvUnlock( &xPrevious );
+
+	/* A store made by the caller may raise an interrupt too; that is seen on
+	the next access or by the event thread. */
+	prvRaiseIrq( ulStatus );
+
+	return pulRegister;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullSimNow( void )
+{
+	return prvNow();
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetInputs( unsigned long ulPort, uint32_t ulMask, uint32_t ulLevels )
+{
+sigset_t xPrevious;
+
+	if( ulPort > 1UL )
+	{
+		return;
+	}
+
+	prvLock( &xPrevious );
+	ulInputLevel[ ulPort ] = ( ulInputLevel[ ulPort ] & ~ulMask ) | ( ulLevels & ulMask );
+	prvVcdWrite( prvNow() );
+	prvUnlock( &xPrevious );
+}
+/*-----------------------------------------------------------*/
+
+void vSimUartReceive( const uint8_t * pucData, size_t xLength )
+{
+sigset_t xPrevious;
+uint64_t ullNow;
+
+	prvLock( &xPrevious );
+	ullNow = prvNow();
+	prvAdvance( ullNow );
+
+	if( xUart1.xHostRxLength + xLength > xUart1.xHostRxSize )
+	{
+		xUart1.xHostRxSize = ( xUart1.xHostRxLength + xLength ) * 2U;
+		xUart1.pucHostRx = realloc( xUart1.pucHostRx, xUart1.xHostRxSize );
+		if( xUart1.pucHostRx == NULL )
+		{
+			abort();
+		}
+	}
+	memcpy( &xUart1.pucHostRx[ xUart1.xHostRxLength ], pucData, xLength );
+	xUart1.xHostRxLength += xLength;
+
+	/* The line has been idle, the first new start bit begins now. */
+	if( ( xUart1.ullRxNextArrival < ullNow ) && ( prvUartCharTime() != simNEVER ) )
+	{
+		xUart1.ullRxNextArrival = ullNow + prvUartCharTime();
+	}
+
+	prvUpdateNextEvent( ullNow );
+	prvUnlock( &xPrevious );
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetUartTxHook( SimUartTxHook_t pxHook )
+{
+	pxTxHook = pxHook;
+}
+/*-----------------------------------------------------------*/
+
+void vSimGetStats( SimStats_t * pxStats )
+{
+sigset_t xPrevious;
+
+	prvLock( &xPrevious );
+	xStats.ullNow = prvNow();
+	*pxStats = xStats;
+	prvUnlock( &xPrevious );
+}
+/*-----------------------------------------------------------*/
+
+void vSimReport( void )
+{
+SimStats_t xReport;
+unsigned x;
+
+	vSimGetStats( &xReport );
+
+	fprintf( stderr, "sim: %.3f ms simulated, speedup %d\n", ( double ) xReport.ullNow / 1e6, SIM_SPEEDUP );
+	fprintf( stderr, "sim: UART1 %llu bytes sent, %llu received, %llu RX overruns, %llu TX FIFO overflows\n",
+			 ( unsigned long long ) xReport.ullUartTxBytes, ( unsigned long long ) xReport.ullUartRxBytes,
+			 ( unsigned long long ) xReport.ullUartRxOverruns, ( unsigned long long ) xReport.ullUartTxFifoOverflows );
+	for( x = 0; x < simVIC_CHANNELS; x++ )
+	{
+		if( xReport.ullIsrEntries[ x ] != 0U )
+		{
+			fprintf( stderr, "sim: VIC channel %u, %llu handler calls\n", x, ( unsigned long long ) xReport.ullIsrEntries[ x ] );
+		}
+	}
+	if( xReport.ullDroppedWrites != 0U )
+	{
+		fprintf( stderr, "sim: %llu register stores lost\n", ( unsigned long long ) xReport.ullDroppedWrites );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+struct timespec xNow;
+uint64_t ullReal;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	ullReal = ( uint64_t ) ( xNow.tv_sec - xStartTime.tv_sec ) * simNS_PER_S + ( uint64_t ) xNow.tv_nsec - ( uint64_t ) xStartTime.tv_nsec;
+
+	return ullReal * ( uint64_t ) SIM_SPEEDUP;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLock( sigset_t * pxPrevious )
+{
+sigset_t xAll;
+
+	sigfillset( &xAll );
+	pthread_sigmask( SIG_BLOCK, &xAll, pxPrevious );
+	pthread_mutex_lock( &xSimLock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlock( const sigset_t * pxPrevious )
+{
+	pthread_mutex_unlock( &xSimLock );
+	pthread_sigmask( SIG_SETMASK, pxPrevious, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdvance( uint64_t ullNow )
+{
+	prvCommitWrites( ullNow );
+	prvGpioAdvance( ullNow );
+	prvTimer1Advance( ullNow );
+	prvUartAdvance( ullNow );
+	prvVcdWrite( ullNow );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCommitWrites( uint64_t ullNow )
+{
+uint32_t x;
+
+	/* Apply completed stores in the order their registers were accessed.  A
+	slot whose store has not happened yet, because the writer was interrupted
+	between the access and the store, is applied on a later pass. */
+	for( x = ulWriteTail; x != ulWriteHead; x++ )
+	{
+		SimWriteSlot_t * const pxSlot = &xWriteSlots[ x % simWRITE_SLOTS ];
+
+		if( ( pxSlot->ucUsed != 0U ) && ( pxSlot->ulValue != simWRITE_SENTINEL ) )
+		{
+			pxSlot->ucUsed = 0;
+			prvApplyWrite( pxSlot->eRegister, pxSlot->ulValue & 0xffffffffUL, ullNow );
+		}
+	}
+
+	while( ( ulWriteTail != ulWriteHead ) && ( xWriteSlots[ ulWriteTail % simWRITE_SLOTS ].ucUsed == 0U ) )
+	{
+		ulWriteTail++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvApplyWrite( SimRegister_t eRegister, unsigned long ulValue, uint64_t ullNow )
+{
+	switch( eRegister )
+	{
+		case simIOSET0:
+			ulOutputLatch[ 0 ] |= ( uint32_t ) ulValue;
+			break;
+
+		case simIOCLR0:
+			ulOutputLatch[ 0 ] &= ~( uint32_t ) ulValue;
+			break;
+
+		case simIOSET1:
+			ulOutputLatch[ 1 ] |= ( uint32_t ) ulValue;
+			break;
+
+		case simIOCLR1:
+			ulOutputLatch[ 1 ] &= ~( uint32_t ) ulValue;
+			break;
+
+		case simU1THR:
+			if( ( ulRegisters[ simU1LCR ] & simLCR_DLAB ) != 0UL )
+			{
+				ulRegisters[ simU1DLL ] = ulValue & 0xffUL;
+				break;
+			}
+
+			if( xUart1.uTxCount < simUART_FIFO_LENGTH )
+			{
+				xUart1.ucTx[ ( xUart1.uTxHead + xUart1.uTxCount ) % simUART_FIFO_LENGTH ] = ( uint8_t ) ulValue;
+				xUart1.uTxCount++;
+			}
+			else
+			{
+				xStats.ullUartTxFifoOverflows++;
+			}
+
+			/* Writing THR clears the THRE interrupt. */
+			xUart1.xThrePending = 0;
+			xUart1.ullThreAt = simNEVER;
+			xUart1.uWrittenSinceThre++;
+
+			if( xUart1.xShifting == 0U )
+			{
+				prvUartStartShift( ullNow );
+			}
+			break;
+
+		case simU1FCR:
+			if( ( ulValue & simFCR_RX_RESET ) != 0UL )
+			{
+				xUart1.uRxCount = 0;
+				xUart1.xTimeoutPending = 0;
+			}
+			if( ( ulValue & simFCR_TX_RESET ) != 0UL )
+			{
+				xUart1.uTxCount = 0;
+			}
+			{
+				static const unsigned uTriggers[ 4 ] = { 1, 4, 8, 14 };
+				xUart1.uRxTrigger = uTriggers[ ( ulValue >> 6 ) & 0x03UL ];
+			}
+			ulRegisters[ simU1FCR ] = ulValue;
+			break;
+
+		case simVICIntEnClr:
+			ulRegisters[ simVICIntEnable ] &= ~ulValue;
+			break;
+
+		case simVICSoftIntClear:
+			ulRegisters[ simVICSoftInt ] &= ~ulValue;
+			break;
+
+		default:
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long prvRead( SimRegister_t eRegister, uint64_t ullNow )
+{
+unsigned long ulValue = 0;
+
+	switch( eRegister )
+	{
+		case simIOPIN0:
+			ulValue = prvPins( 0 );
+			break;
+
+		case simIOPIN1:
+			ulValue = prvPins( 1 );
+			break;
+
+		case simU1RBR:
+			if( ( ulRegisters[ simU1LCR ] & simLCR_DLAB ) != 0UL )
+			{
+				ulValue = ulRegisters[ simU1DLL ];
+			}
+			else if( xUart1.uRxCount > 0U )
+			{
+				ulValue = xUart1.ucRx[ xUart1.uRxHead ];
+				xUart1.uRxHead = ( xUart1.uRxHead + 1U ) % simUART_FIFO_LENGTH;
+				xUart1.uRxCount--;
+				xUart1.ullRxLastActivity = ullNow;
+				xUart1.xTimeoutPending = 0;
+			}
+			break;
+
+		case simU1IIR:
+			ulValue = prvUartIir( ullNow );
+
+			/* Reading IIR clears a THRE interrupt it reports. */
+			if( ( ulValue & 0x0fUL ) == simIIR_THRE )
+			{
+				xUart1.xThrePending = 0;
+			}
+			break;
+
+		case simU1LSR:
+			ulValue = xUart1.ulLsrErrors;
+			xUart1.ulLsrErrors = 0;
+			if( xUart1.uRxCount > 0U )
+			{
+				ulValue |= simLSR_RDR;
+			}
+			if( xUart1.uTxCount == 0U )
+			{
+				ulValue |= simLSR_THRE;
+				if( xUart1.xShifting == 0U )
+				{
+					ulValue |= simLSR_TEMT;
+				}
+			}
+			break;
+
+		case simT1TC:
+			ulValue = prvTimer1Count( ullNow );
+			break;
+
+		case simVICRawIntr:
+			ulValue = prvVicPending( ullNow ) | ulRegisters[ simVICSoftInt ];
+			break;
+
+		case simVICIRQStatus:
+			ulValue = prvIrqStatus( ullNow );
+			break;
+
+		default:
+			break;
+	}
+
+	return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPins( unsigned long ulPort )
+{
+const uint32_t ulOutputs = ( uint32_t ) ulRegisters[ ( ulPort == 0UL ) ? simIODIR0 : simIODIR1 ];
+
+	return ( ulOutputLatch[ ulPort ] & ulOutputs ) | ( ulInputLevel[ ulPort ] & ~ulOutputs );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGpioAdvance( uint64_t ullNow )
+{
+	while( ( xGpioScriptNext < xGpioScriptLength ) && ( pxGpioScript[ xGpioScriptNext ].ullTime <= ullNow ) )
+	{
+		const SimGpioEvent_t * const pxEvent = &pxGpioScript[ xGpioScriptNext++ ];
+
+		ulInputLevel[ pxEvent->ulPort ] = ( ulInputLevel[ pxEvent->ulPort ] & ~pxEvent->ulMask ) | pxEvent->ulLevel;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPclk( unsigned long ulVpbdiv )
+{
+	switch( ulVpbdiv & 0x03UL )
+	{
+		case 1:
+			return configCPU_CLOCK_HZ;
+
+		case 2:
+			return configCPU_CLOCK_HZ / 2UL;
+
+		default:
+			return configCPU_CLOCK_HZ / 4UL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimer1Count( uint64_t ullNow )
+{
+uint64_t ullElapsed, ullHz;
+
+	if( ( xTimer1.ulTcr & simTCR_RESET ) != 0UL )
+	{
+		return 0;
+	}
+	if( ( xTimer1.ulTcr & simTCR_ENABLE ) == 0UL )
+	{
+		return xTimer1.ulBase;
+	}
+
+	ullElapsed = ullNow - xTimer1.ullBaseTime;
+	ullHz = prvPclk( xTimer1.ulVpbdiv ) / ( ( xTimer1.ulPr & 0xffffffffUL ) + 1UL );
+
+	return xTimer1.ulBase + ( uint32_t ) ( ( ullElapsed / simNS_PER_S ) * ullHz + ( ( ullElapsed % simNS_PER_S ) * ullHz ) / simNS_PER_S );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimer1Advance( uint64_t ullNow )
+{
+	/* New settings take effect from now on; keep the count reached so far. */
+	if( ( xTimer1.ulTcr != ulRegisters[ simT1TCR ] ) || ( xTimer1.ulPr != ulRegisters[ simT1PR ] ) ||
+		( xTimer1.ulVpbdiv != ulRegisters[ simVPBDIV ] ) )
+	{
+		xTimer1.ulBase = prvTimer1Count( ullNow );
+		xTimer1.ullBaseTime = ullNow;
+		xTimer1.ulTcr = ulRegisters[ simT1TCR ];
+		xTimer1.ulPr = ulRegisters[ simT1PR ];
+		xTimer1.ulVpbdiv = ulRegisters[ simVPBDIV ];
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvUartCharTime( void )
+{
+const unsigned long ulLcr = ulRegisters[ simU1LCR ];
+const uint64_t ullDivisor = ( ( ulRegisters[ simU1DLM ] & 0xffUL ) << 8 ) | ( ulRegisters[ simU1DLL ] & 0xffUL );
+uint64_t ullBits;
+
+	if( ullDivisor == 0U )
+	{
+		return simNEVER;
+	}
+
+	/* Start bit, 5 to 8 data bits, optional parity, 1 or 2 stop bits. */
+	ullBits = 1U + 5U + ( ulLcr & 0x03UL ) + ( ( ulLcr >> 3 ) & 0x01UL ) + 1U + ( ( ulLcr >> 2 ) & 0x01UL );
+
+	return ( ullBits * 16U * ullDivisor * simNS_PER_S ) / prvPclk( ulRegisters[ simVPBDIV ] );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUartStartShift( uint64_t ullNow )
+{
+const uint64_t ullCharTime = prvUartCharTime();
+
+	if( ( xUart1.uTxCount == 0U ) || ( ullCharTime == simNEVER ) )
+	{
+		return;
+	}
+
+	xUart1.ucShiftByte = xUart1.ucTx[ xUart1.uTxHead ];
+	xUart1.uTxHead = ( xUart1.uTxHead + 1U ) % simUART_FIFO_LENGTH;
+	xUart1.uTxCount--;
+	xUart1.xShifting = 1;
+	xUart1.ullShiftEnd = ullNow + ullCharTime;
+
+	if( xUart1.uTxCount == 0U )
+	{
+		if( xUart1.uWrittenSinceThre >= 2U )
+		{
+			xUart1.ullThreAt = ullNow;
+		}
+		else
+		{
+			xUart1.ullThreAt = ullNow + ullCharTime - ( ullCharTime / 10U );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvUartAdvance( uint64_t ullNow )
+{
+const uint64_t ullCharTime = prvUartCharTime();
+const unsigned long ulIer = ulRegisters[ simU1IER ];
+
+	/* Enabling the THRE interrupt with an empty THR raises it at once. */
+	if( ( ( ulIer & ~xUart1.ulLastIer ) & simIER_THRE ) != 0UL )
+	{
+		if( xUart1.uTxCount == 0U )
+		{
+			xUart1.xThrePending = 1;
+		}
+	}
+	xUart1.ulLastIer = ulIer;
+
+	/* Nothing moves until a baud rate is programmed; received bytes start
+	arriving one character after that. */
+	if( ullCharTime != xUart1.ullLastCharTime )
+	{
+		if( ( xUart1.ullLastCharTime == simNEVER ) && ( ullCharTime != simNEVER ) )
+		{
+			xUart1.ullRxNextArrival = ullNow + ullCharTime;
+		}
+		xUart1.ullLastCharTime = ullCharTime;
+	}
+	if( ( xUart1.xShifting == 0U ) && ( xUart1.uTxCount > 0U ) )
+	{
+		prvUartStartShift( ullNow );
+	}
+
+	for( ;; )
+	{
+		if( ( xUart1.ullThreAt != simNEVER ) && ( xUart1.ullThreAt <= ullNow ) &&
+			( ( xUart1.xShifting == 0U ) || ( xUart1.ullThreAt <= xUart1.ullShiftEnd ) ) )
+		{
+			if( xUart1.uTxCount == 0U )
+			{
+				xUart1.xThrePending = 1;
+				xUart1.uWrittenSinceThre = 0;
+			}
+			xUart1.ullThreAt = simNEVER;
+		}
+		else if( ( xUart1.xShifting != 0U ) && ( xUart1.ullShiftEnd <= ullNow ) )
+		{
+			const uint64_t ullEnd = xUart1.ullShiftEnd;
+
+			xUart1.xShifting = 0;
+			xStats.ullUartTxBytes++;
+
+			if( pxTxHook != NULL )
+			{
+				pxTxHook( xUart1.ucShiftByte, ullEnd );
+			}
+			else if( write( iTxFd, &xUart1.ucShiftByte, 1 ) < 0 )
+			{
+				/* Nothing useful to do, the byte is counted as sent. */
+			}
+
+			prvUartStartShift( ullEnd );
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	/* Received bytes, one character time apart. */
+	while( ( xUart1.xHostRxNext < xUart1.xHostRxLength ) && ( ullCharTime != simNEVER ) && ( xUart1.ullRxNextArrival <= ullNow ) )
+	{
+		if( xUart1.uRxCount < simUART_FIFO_LENGTH )
+		{
+			xUart1.ucRx[ ( xUart1.uRxHead + xUart1.uRxCount ) % simUART_FIFO_LENGTH ] = xUart1.pucHostRx[ xUart1.xHostRxNext ];
+			xUart1.uRxCount++;
+		}
+		else
+		{
+			xUart1.ulLsrErrors |= simLSR_OE;
+			xStats.ullUartRxOverruns++;
+		}
+
+		xUart1.xHostRxNext++;
+		xUart1.xTimeoutPending = 0;
+		xStats.ullUartRxBytes++;
+		xUart1.ullRxLastActivity = xUart1.ullRxNextArrival;
+		xUart1.ullRxNextArrival += ullCharTime;
+	}
+
+	if( xUart1.xHostRxNext == xUart1.xHostRxLength )
+	{
+		xUart1.xHostRxNext = 0;
+		xUart1.xHostRxLength = 0;
+	}
+
+	/* Character timeout: data below the trigger level and no activity for
+	four character times. */
+	if( ( xUart1.uRxCount > 0U ) && ( ullCharTime != simNEVER ) && ( ( ullNow - xUart1.ullRxLastActivity ) >= ( 4U * ullCharTime ) ) )
+	{
+		xUart1.xTimeoutPending = 1;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long prvUartIir( uint64_t ullNow )
+{
+const unsigned long ulIer = ulRegisters[ simU1IER ];
+const unsigned long ulFifos = ( ( ulRegisters[ simU1FCR ] & simFCR_FIFO_ENABLE ) != 0UL ) ? simIIR_FIFOS_ENABLED : 0UL;
+
+	( void ) ullNow;
+
+	if( ( ( ulIer & simIER_RLS ) != 0UL ) && ( xUart1.ulLsrErrors != 0UL ) )
+	{
+		return ulFifos | simIIR_RLS;
+	}
+	if( ( ulIer & simIER_RBR ) != 0UL )
+	{
+		if( xUart1.uRxCount >= xUart1.uRxTrigger )
+		{
+			return ulFifos | simIIR_RDA;
+		}
+		if( ( xUart1.uRxCount > 0U ) && ( xUart1.xTimeoutPending != 0U ) )
+		{
+			return ulFifos | simIIR_CTI;
+		}
+	}
+	if( ( ( ulIer & simIER_THRE ) != 0UL ) && ( xUart1.xThrePending != 0U ) )
+	{
+		return ulFifos | simIIR_THRE;
+	}
+
+	return ulFifos | simIIR_NO_INTERRUPT;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvVicPending( uint64_t ullNow )
+{
+uint32_t ulRaw = 0;
+
+	if( ( prvUartIir( ullNow ) & simIIR_NO_INTERRUPT ) == 0UL )
+	{
+		ulRaw |= 1UL << simVIC_UART1_CHANNEL;
+	}
+
+	return ulRaw;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateNextEvent( uint64_t ullNow )
+{
+const uint64_t ullCharTime = prvUartCharTime();
+uint64_t ullNext = simNEVER;
+
+	if( xUart1.xShifting != 0U )
+	{
+		ullNext = xUart1.ullShiftEnd;
+	}
+	if( xUart1.ullThreAt < ullNext )
+	{
+		ullNext = xUart1.ullThreAt;
+	}
+	if( ( xUart1.xHostRxNext < xUart1.xHostRxLength ) && ( xUart1.ullRxNextArrival < ullNext ) )
+	{
+		ullNext = xUart1.ullRxNextArrival;
+	}
+	if( ( xUart1.uRxCount > 0U ) && ( xUart1.xTimeoutPending == 0U ) && ( ullCharTime != simNEVER ) &&
+		( xUart1.ullRxLastActivity + ( 4U * ullCharTime ) < ullNext ) )
+	{
+		ullNext = xUart1.ullRxLastActivity + ( 4U * ullCharTime );
+	}
+	if( ( xGpioScriptNext < xGpioScriptLength ) && ( pxGpioScript[ xGpioScriptNext ].ullTime < ullNext ) )
+	{
+		ullNext = pxGpioScript[ xGpioScriptNext ].ullTime;
+	}
+
+	/* Wake the event thread when a register access brought the next event
+	forward, e.g. a THR store starting a byte on an idle line.  The caller
+	holds xSimLock with every signal blocked, so this never runs from inside
+	an interrupted condition variable call. */
+	( void ) ullNow;
+	if( ullNext < atomic_exchange( &ullNextEvent, ullNext ) )
+	{
+		pthread_cond_signal( &xEventChanged );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvIrqStatus( uint64_t ullNow )
+{
+	return ( prvVicPending( ullNow ) | ( uint32_t ) ulRegisters[ simVICSoftInt ] ) & ( uint32_t ) ulRegisters[ simVICIntEnable ] & ~( uint32_t ) ulRegisters[ simVICIntSelect ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvRaiseIrq( uint32_t ulStatus )
+{
+	if( ( ulStatus != 0U ) && ( atomic_exchange( &xIrqRaised, true ) == false ) )
+	{
+		/* Delivered to whichever thread has the signal unblocked, which is the
+		running FreeRTOS task once it has interrupts enabled. */
+		kill( getpid(), simIRQ_SIGNAL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvIrqHandler( int iSignal )
+{
+int iLoop;
+
+	( void ) iSignal;
+	atomic_store( &xIrqRaised, false );
+
+	for( iLoop = 0; iLoop < simMAX_DISPATCH_LOOPS; iLoop++ )
+	{
+		void ( * pxHandler )( void ) = NULL;
+		sigset_t xPrevious;
+		uint64_t ullNow;
+		uint32_t ulStatus;
+		unsigned x, uChannel = 0;
+
+		prvLock( &xPrevious );
+		ullNow = prvNow();
+		prvAdvance( ullNow );
+		ulStatus = prvIrqStatus( ullNow );
+
+		if( ulStatus != 0U )
+		{
+			/* Vectored slots in priority order, then the default vector. */
+			for( x = 0; x < 16U; x++ )
+			{
+				const unsigned long ulControl = ulRegisters[ simVICVectCntl0 + x ];
+
+				if( ( ( ulControl & simVECTCNTL_ENABLE ) != 0UL ) && ( ( ulStatus & ( 1UL << ( ulControl & simVECTCNTL_CHANNEL_MASK ) ) ) != 0U ) )
+				{
+					pxHandler = ( void ( * )( void ) ) ulRegisters[ simVICVectAddr0 + x ];
+					uChannel = ( unsigned ) ( ulControl & simVECTCNTL_CHANNEL_MASK );
+					break;
+				}
+			}
+
+			if( pxHandler == NULL )
+			{
+				pxHandler = ( void ( * )( void ) ) ulRegisters[ simVICDefVectAddr ];
+				uChannel = ( unsigned ) __builtin_ctz( ulStatus );
+			}
+
+			ulRegisters[ simVICVectAddr ] = ( unsigned long ) pxHandler;
+			xStats.ullIsrEntries[ uChannel ]++;
+		}
+		prvUnlock( &xPrevious );
+
+		if( pxHandler == NULL )
+		{
+			break;
+		}
+
+		pxHandler();
+
+		/* Stores made by the handler are applied before the next decision. */
+		prvLock( &xPrevious );
+		ullNow = prvNow();
+		prvAdvance( ullNow );
+		prvUpdateNextEvent( ullNow );
+		prvUnlock( &xPrevious );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void * prvEventThread( void * pvParameters )
+{
+sigset_t xAll, xPrevious;
+uint32_t ulStatus;
+
+	( void ) pvParameters;
+
+	sigfillset( &xAll );
+	pthread_sigmask( SIG_BLOCK, &xAll, NULL );
+
+	/* The default 50 us timer slack would add a character time at 115200
+	baud to every wake up. */
+	prctl( PR_SET_TIMERSLACK, 1UL );
+
+	for( ;; )
+	{
+		uint64_t ullNow = prvNow(), ullNext, ullSleep;
+		struct timespec xWake;
+
+		if( ullNow >= ullRunLimit )
+		{
+			vSimReport();
+			fflush( NULL );
+			_exit( 0 );
+		}
+
+		prvLock( &xPrevious );
+		prvAdvance( ullNow );
+		prvUpdateNextEvent( ullNow );
+		ulStatus = prvIrqStatus( ullNow );
+
+		/* Wait in real time until the next simulated event, or until a
+		register access schedules an earlier one. */
+		ullNext = atomic_load( &ullNextEvent );
+		if( ullRunLimit < ullNext )
+		{
+			ullNext = ullRunLimit;
+		}
+		ullSleep = ( ullNext > ullNow ) ? ( ullNext - ullNow ) / ( uint64_t ) SIM_SPEEDUP : 0U;
+		if( ullSleep > simPOLL_REAL_NS )
+		{
+			ullSleep = simPOLL_REAL_NS;
+		}
+
+		/* A request the running thread has masked is polled again soon
+		rather than spun on. */
+		if( ( ulStatus != 0U ) && ( ullSleep > simIRQ_RETRY_REAL_NS ) )
+		{
+			ullSleep = simIRQ_RETRY_REAL_NS;
+		}
+		prvRaiseIrq( ulStatus );
+
+		if( ullSleep != 0U )
+		{
+			clock_gettime( CLOCK_MONOTONIC, &xWake );
+			xWake.tv_nsec += ( long ) ullSleep;
+			if( xWake.tv_nsec >= ( long ) simNS_PER_S )
+			{
+				xWake.tv_sec++;
+				xWake.tv_nsec -= ( long ) simNS_PER_S;
+			}
+			pthread_cond_timedwait( &xEventChanged, &xSimLock, &xWake );
+		}
+		prvUnlock( &xPrevious );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadRxFile( const char * pcPath )
+{
+FILE * pxFile = fopen( pcPath, "rb" );
+uint8_t ucBuffer[ 4096 ];
+size_t xRead;
+
+	if( pxFile == NULL )
+	{
+		perror( pcPath );
+		exit( 1 );
+	}
+
+	while( ( xRead = fread( ucBuffer, 1, sizeof( ucBuffer ), pxFile ) ) > 0U )
+	{
+		vSimUartReceive( ucBuffer, xRead );
+	}
+
+	fclose( pxFile );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareGpioEvents( const void * pvA, const void * pvB )
+{
+const SimGpioEvent_t * pxA = pvA, * pxB = pvB;
+
+	return ( pxA->ullTime > pxB->ullTime ) - ( pxA->ullTime < pxB->ullTime );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadGpioScript( const char * pcPath )
+{
+FILE * pxFile = fopen( pcPath, "r" );
+char cLine[ 256 ];
+size_t xSize = 0;
+
+	if( pxFile == NULL )
+	{
+		perror( pcPath );
+		exit( 1 );
+	}
+
+	/* "<ms> <port> <pin> <0|1>" per line, '#' starts a comment. */
+	while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+	{
+		double dMs;
+		unsigned long ulPort, ulPin, ulLevel;
+
+		if( ( cLine[ 0 ] == '#' ) || ( sscanf( cLine, "%lf %lu %lu %lu", &dMs, &ulPort, &ulPin, &ulLevel ) != 4 ) ||
+			( ulPort > 1UL ) || ( ulPin > 31UL ) )
+		{
+			continue;
+		}
+
+		if( xGpioScriptLength == xSize )
+		{
+			xSize = ( xSize == 0U ) ? 64U : xSize * 2U;
+			pxGpioScript = realloc( pxGpioScript, xSize * sizeof( SimGpioEvent_t ) );
+			if( pxGpioScript == NULL )
+			{
+				abort();
+			}
+		}
+
+		pxGpioScript[ xGpioScriptLength ].ullTime = ( uint64_t ) ( dMs * 1e6 );
+		pxGpioScript[ xGpioScriptLength ].ulPort = ulPort;
+		pxGpioScript[ xGpioScriptLength ].ulMask = 1UL << ulPin;
+		pxGpioScript[ xGpioScriptLength ].ulLevel = ( ulLevel != 0UL ) ? ( 1UL << ulPin ) : 0UL;
+		xGpioScriptLength++;
+	}
+
+	fclose( pxFile );
+	qsort( pxGpioScript, xGpioScriptLength, sizeof( SimGpioEvent_t ), prvCompareGpioEvents );
+}
+/*-----------------------------------------------------------*/
+
+static void prvVcdOpen( const char * pcPath )
+{
+	pxVcd = fopen( pcPath, "w" );
+	if( pxVcd == NULL )
+	{
+		perror( pcPath );
+		exit( 1 );
+	}
+
+	fprintf( pxVcd, "$timescale 1ns $end\n$scope module lpc2129 $end\n" );
+	fprintf( pxVcd, "$var wire 32 ! P0 $end\n$var wire 32 \" P1 $end\n" );
+	fprintf( pxVcd, "$upscope $end\n$enddefinitions $end\n" );
+	fprintf( pxVcd, "#0\nb0 !\nb0 \"\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvVcdWrite( uint64_t ullNow )
+{
+unsigned long ulPort;
+int iBit;
+uint8_t xTimeWritten = 0;
+
+	if( pxVcd == NULL )
+	{
+		return;
+	}
+
+	for( ulPort = 0; ulPort < 2UL; ulPort++ )
+	{
+		const uint32_t ulPins = prvPins( ulPort );
+
+		if( ulPins != ulLastPins[ ulPort ] )
+		{
+			if( xTimeWritten == 0U )
+			{
+				fprintf( pxVcd, "#%llu\n", ( unsigned long long ) ullNow );
+				xTimeWritten = 1;
+			}
+
+			fputc( 'b', pxVcd );
+			for( iBit = 31; iBit >= 0; iBit-- )
+			{
+				fputc( ( ( ulPins >> iBit ) & 1U ) ? '1' : '0', pxVcd );
+			}
+			fprintf( pxVcd, " %c\n", ( ulPort == 0UL ) ? '!' : '"' );
+			ulLastPins[ ulPort ] = ulPins;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/*
+ * Board glue that the host build supplies in place of the Keil project:
+ * the assembly interrupt entry points and default application hooks for
+ * programs that do not define them.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------*/
+
+/* serial.c installs vUART_ISREntry in the VIC.  On the board it is the asm
+wrapper in serialISR.s that saves the task context around the C handler; on
+the host the simulator's IRQ signal handler already runs on the interrupted
+thread's stack, so the wrapper only forwards. */
+extern void vUART_ISRHandler( void );
+
+void vUART_ISREntry( void )
+{
+	vUART_ISRHandler();
+}
+/*-----------------------------------------------------------*/
+
+/* The IPC demos were built with the hooks disabled; the Final Project
+configuration enables them, so they default to doing nothing. */
+__attribute__( ( weak ) ) void vApplicationIdleHook( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+__attribute__( ( weak ) ) void vApplicationTickHook( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+__attribute__( ( weak ) ) void vApplicationDeadlineMissHook( TaskHandle_t xTask, TickType_t xLateness )
+{
+	( void ) xTask;
+	( void ) xLateness;
+}
+/*-----------------------------------------------------------*/
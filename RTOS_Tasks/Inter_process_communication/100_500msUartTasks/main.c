@@ -68,6 +68,8 @@
 #include "serial.h"
 #include "GPIO.h"
  #include "event_groups.h"
+#include "cpu_burn.h"
+#include "uart_server.h"
  
 /*-----------------------------------------------------------*/
 
@@ -77,6 +79,10 @@
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
+/* The UART server preempts both writers so their requests are taken as soon
+as they are queued. */
+#define mainUART_SERVER_PRIORITY	( 2 )
+
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -89,79 +95,45 @@ static void prvSetupHardware( void );
 #define LESS_THAN_2_sec		2
 #define MORE_THAN_4_sec		3
 
+/* CPU time burnt between and after the UART writes, roughly what the old
+counting loops took at 60 MHz. */
+#define mainWRITE_GAP_US			500UL
+#define mainTASK1_AFTER_WRITES_US	12500UL
+#define mainTASK2_AFTER_WRITES_US	625UL
+
 int LED_state= PIN_IS_LOW;
 int counter=0;
 
-SemaphoreHandle_t UART_Semaphore;
 EventGroupHandle_t Toggle_Event;
 
-
-		int b2;
-volatile int i;
 void task1_500(void* pvParameters)
 {
 	while(1)
 	{
+		/* Queued for the UART server, so the 100 ms task is never held up
+		by this burst. */
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task1_500\r\n",11,uartserverPRIORITY_LOW);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
 		
-		xSemaphoreTake(UART_Semaphore,5000000);
-		
-		b2= uxSemaphoreGetCount(UART_Semaphore);
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task1_500\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		
-		xSemaphoreGive(UART_Semaphore);
-		for(i=0;i<100000;)
-		{
-			++i;
-		}
+		vBurnCpuMicroseconds(mainTASK1_AFTER_WRITES_US);
 			
 		vTaskDelay(pdMS_TO_TICKS(500));
 	}
@@ -172,61 +144,27 @@ void task2_100(void* pvParameters)
 {
 	while(1)
 	{
-		int b= uxSemaphoreGetCount(UART_Semaphore);
-		
-		xSemaphoreTake(UART_Semaphore,5000000);
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		for(i=0;i<4000;)
-		{
-			++i;
-		}
-		vSerialPutString((signed char *)"task2_100\r\n",11);
-		xSemaphoreGive(UART_Semaphore);
-		for(i=0;i<5000;)
-		{
-			++i;
-		}
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainWRITE_GAP_US);
+		xUartServerSend("task2_100\r\n",11,uartserverPRIORITY_HIGH);
+		vBurnCpuMicroseconds(mainTASK2_AFTER_WRITES_US);
 		
 			
 		vTaskDelay(pdMS_TO_TICKS(100));
@@ -253,9 +191,12 @@ int main( void )
 	
 	prvSetupHardware();
 	
-	UART_Semaphore =xSemaphoreCreateBinary();	//creat semaphore for protecting the shared uart
-	
-	xSemaphoreGive(UART_Semaphore); // initial value
+	if(xUartServerStart(mainUART_SERVER_PRIORITY) != pdPASS)	// the server task owns the uart from here on
+	{
+		/* Not enough heap for its queues or task: the writers would trip the
+		assert in xUartServerSend, so stop before the scheduler. */
+		for( ;; );
+	}
 	
 	xTaskCreate( task1_500, /* Pointer to the function that implements the task. */
 							 "task1_500",/* Text name for the task. This is to facilitate debugging only. */
@@ -291,6 +232,9 @@ static void prvSetupHardware( void )
 
 	/* Setup the peripheral bus to be the same as the PLL output. */
 	VPBDIV = mainBUS_CLK_FULL;
+
+	/* Time the CPU burner against Timer 1 at the final bus clock */
+	vBurnCpuCalibrate();
 }
 /*-----------------------------------------------------------*/
 
@@ -67,8 +67,11 @@
 /* Peripheral includes. */
 #include "serial.h"
 #include "GPIO.h"
+#include "gpio_snapshot.h"
+#include "input_events.h"
  #include "event_groups.h"
  #include "string.h"
+#include "log_ring.h"
 /*-----------------------------------------------------------*/
 
 /* Constants to setup I/O and processor. */
@@ -77,6 +80,9 @@
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
+/* Timer 1 timestamps the log records. */
+#define mainT1TCR_COUNTER_ENABLE	( 0x01UL )
+
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -90,64 +96,47 @@ static void prvSetupHardware( void );
 #define MORE_THAN_4_sec		3
 
 int LED_state= PIN_IS_LOW;
-int counter=0;
-int counter2=0;
-QueueHandle_t UART_Queue;
+unsigned long rising_edges=0;
+unsigned long falling_edges=0;
 
 
 
 int b2;
 volatile int i;
-void task1_RisingEdge(void* pvParameters)
+/* the input service samples the latched inputs, see EDF/gpio_snapshot.h */
+void vApplicationTickHook( void )
 {
-	while(1)
-	{
-			if(counter ==0 && GPIO_read(PORT_0,PIN0)==PIN_IS_HIGH)
-		{	
-			counter++;
-			//here indicates a rising edge
-			const char *RE_="Rising Edge \r\n";
-			char  RE_data[15];//=malloc(strlen(RE_)+1);
-			strcpy(RE_data,RE_);
-			xQueueSendToBack(UART_Queue,&RE_data,5000000);
-		}	
-		else if(GPIO_read(PORT_0,PIN0)==PIN_IS_LOW)
-		{	
-			
-			counter = 0;
-		}
-		else 
-		{
-			//do nothing
-		}
-		vTaskDelay(pdMS_TO_TICKS(20));
-	}
-	
+	vGpioSnapshotTick();
 }
 
-void task2_FallingEdge(void* pvParameters)
+void task1_Edges(void* pvParameters)
 {
+	InputEvents_t events;
+	
+	// one debounced subscriber instead of a rising and a falling polling task,
+	// woken by the input service only when the button changed (see EDF/input_events.h)
+	InputSubscriberHandle_t button = xInputEventsSubscribe(inputBIT(PORT_0,PIN0));
+	
 	while(1)
 	{
-		if(GPIO_read(PORT_0,PIN0)==PIN_IS_HIGH)
+		xInputEventsWait(button,&events,portMAX_DELAY);
+		
+		if((events.ulRising & inputBIT(PORT_0,PIN0)) != 0)
 		{	
-			counter2++;
+			//here indicates a rising edge
+			rising_edges++;
+			logPRINT1(logEDGE_RISING,rising_edges);
 		}	
-		else if(counter2 !=0 && GPIO_read(PORT_0,PIN0)==PIN_IS_LOW)
+		if((events.ulFalling & inputBIT(PORT_0,PIN0)) != 0)
 		{	
 			// here indicates a falling edge 
-			counter2 = 0;
-			
-			const char *FE="Falling Edge\r\n";
-			char  FE_data[15];//=malloc(strlen(FE)+1);
-			strcpy(FE_data,FE);
-			xQueueSendToBack(UART_Queue,&FE_data,5000000);
+			falling_edges++;
+			logPRINT1(logEDGE_FALLING,falling_edges);
 		}
-		else 
+		if((events.ulLongPress & inputBIT(PORT_0,PIN0)) != 0)
 		{
-			//do nothing
+			logPRINT0(logLONG_PRESS);
 		}
-		vTaskDelay(pdMS_TO_TICKS(20));
 	}
 	
 }
@@ -156,10 +145,7 @@ void task3_100msString(void* pvParameters)
 {
 	while(1)
 	{
-		const char *PS="Hello       \r\n";
-		char PS_data[15];//=malloc(strlen(PS)+1);
-		strcpy(PS_data,PS);
-		xQueueSendToBack(UART_Queue,&PS_data,5000000);
+		logPRINT0(logHELLO);
 		vTaskDelay(pdMS_TO_TICKS(100));
 	}
 	
@@ -169,11 +155,8 @@ void task4_ConsumerUart(void* pvParameters)
 {
 	while(1)
 	{
-		char x[15];
-		
-		xQueueReceive(UART_Queue,&x,5000000);
-		
-		vSerialPutString((signed char*)x,14);
+		// send the pending log records, Tools/log_decode prints them as text
+		vLogRingDrain();
 				
 		vTaskDelay(pdMS_TO_TICKS(10));
 	}
@@ -198,7 +181,6 @@ int main( void )
 	
 	prvSetupHardware();
 	
-	UART_Queue = xQueueCreate(9,15);
 	xTaskCreate( task3_100msString, /* Pointer to the function that implements the task. */
 							 "task2_100",/* Text name for the task. This is to facilitate debugging only. */
 							 100, /* Stack depth - small microcontrollers will use much less stack than this. */
@@ -212,20 +194,14 @@ int main( void )
 							 1, 		/* This task will run at priority 1. */
 							 NULL ); /* This example does not use the task handle. */					
 
-	xTaskCreate( task1_RisingEdge, /* Pointer to the function that implements the task. */
-							 "task1_500",/* Text name for the task. This is to facilitate debugging only. */
+	xTaskCreate( task1_Edges, /* Pointer to the function that implements the task. */
+							 "task1_edges",/* Text name for the task. This is to facilitate debugging only. */
 							 100, /* Stack depth - small microcontrollers will use much less stack than this. */
 							 NULL, /* This example does not use the task parameter. */
 							 1, 		/* This task will run at priority 1. */
 							 NULL ); /* This example does not use the task handle. */
-						
 
-	xTaskCreate( task2_FallingEdge, /* Pointer to the function that implements the task. */
-							 "task1_500",/* Text name for the task. This is to facilitate debugging only. */
-							 100, /* Stack depth - small microcontrollers will use much less stack than this. */
-							 NULL, /* This example does not use the task parameter. */
-							 1, 		/* This task will run at priority 1. */
-							 NULL ); /* This example does not use the task handle. */
+	xInputEventsStart(2);	// debounces the button, replaces the two edge polling tasks
 						
 						
 
@@ -246,9 +222,14 @@ static void prvSetupHardware( void )
 
 	/* Configure GPIO */
 	GPIO_init();
+	vGpioSnapshotInit();
 
 	/* Setup the peripheral bus to be the same as the PLL output. */
 	VPBDIV = mainBUS_CLK_FULL;
+
+	/* Start Timer 1 for the log timestamps */
+	T1PR = configTRACE_TIMER_PRESCALE;
+	T1TCR = mainT1TCR_COUNTER_ENABLE;
 }
 /*-----------------------------------------------------------*/
 
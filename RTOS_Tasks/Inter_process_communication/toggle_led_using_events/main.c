@@ -67,6 +67,8 @@
 /* Peripheral includes. */
 #include "serial.h"
 #include "GPIO.h"
+#include "gpio_snapshot.h"
+#include "input_events.h"
  #include "event_groups.h"
  
 /*-----------------------------------------------------------*/
@@ -88,54 +90,35 @@ static void prvSetupHardware( void );
 
 
 int LED_state= PIN_IS_LOW;
-int counter=0;
 
 SemaphoreHandle_t Toggle_LED;
-EventGroupHandle_t Toggle_Event;
 
 
 
-void button_tracker( void *pvParameters )
+/* latch the button with the other inputs, see EDF/gpio_snapshot.h */
+void vApplicationTickHook( void )
 {
-	
-		
-	while(1)
-	{
-		if(GPIO_read(PORT_0,PIN0)==PIN_IS_HIGH)
-		{	
-			counter++;
-		}	
-		else if(counter !=0 && GPIO_read(PORT_0,PIN0)==PIN_IS_LOW)
-		{	
-			// here indicates a falling edge 
-			counter = 0;
-
-			//give set bit 0 in the event group
-			xEventGroupSetBits(Toggle_Event,(1<<0));
-		}
-		else 
-		{
-			//do nothing
-		}
-		
-		vTaskDelay (pdMS_TO_TICKS(50));
-	}
-	
+	vGpioSnapshotTick();
 }
 
 void LED_Toggle(void* pvParameters)
 {
+	InputEvents_t events;
+	
+	// the input service debounces the button and wakes this task on its edges,
+	// no task polls the pin any more (see EDF/input_events.h)
+	InputSubscriberHandle_t button = xInputEventsSubscribe(inputBIT(PORT_0,PIN0));
+	
 	while(1)
 	{
-		// read the EventGroup bits, 
-		// if there is new event will toggle LED and clear the event flag. 
-		// but if there is no event this task will be blocked until there is an new flag.
+		// blocked until there is a new event, 
+		// a release of the button (falling edge) toggles the LED.
 
-		int temp= xEventGroupWaitBits(Toggle_Event,1,pdTRUE,pdFALSE,10000);
-
-		GPIO_write(PORT_0,PIN1,(LED_state^0X01));
-		LED_state= LED_state^0X01;		// toggle the led state
-		vTaskDelay(pdMS_TO_TICKS(50));
+		if(xInputEventsWait(button,&events,portMAX_DELAY)==pdTRUE && (events.ulFalling & inputBIT(PORT_0,PIN0)) != 0)
+		{
+			GPIO_write(PORT_0,PIN1,(LED_state^0X01));
+			LED_state= LED_state^0X01;		// toggle the led state
+		}
 	}
 	
 }
@@ -205,7 +188,7 @@ int main( void )
 	LED_state=0;
 	prvSetupHardware();
 	//Toggle_LED=xSemaphoreCreateBinary();
-	Toggle_Event = xEventGroupCreate();
+	xInputEventsStart(2);	// debounces the button for LED_Toggle, replaces the button_tracker task
 	xTaskCreate( LED_Toggle, /* Pointer to the function that implements the task. */
 							 "led toggling",/* Text name for the task. This is to facilitate debugging only. */
 							 100, /* Stack depth - small microcontrollers will use much less stack than this. */
@@ -213,12 +196,6 @@ int main( void )
 							 1, 		/* This task will run at priority 1. */
 							 NULL ); /* This example does not use the task handle. */
 						
-	xTaskCreate( button_tracker, /* Pointer to the function that implements the task. */
-							 "button tracker",/* Text name for the task. This is to facilitate debugging only. */
-							 100, /* Stack depth - small microcontrollers will use much less stack than this. */
-							 NULL, /* This example does not use the task parameter. */
-							 2, 		/* This task will run at priority 1. */
-							 NULL ); /* This example does not use the task handle. */							
 
 	vTaskStartScheduler();
 
@@ -237,6 +214,7 @@ static void prvSetupHardware( void )
 
 	/* Configure GPIO */
 	GPIO_init();
+	vGpioSnapshotInit();
 
 	/* Setup the peripheral bus to be the same as the PLL output. */
 	VPBDIV = mainBUS_CLK_FULL;
@@ -0,0 +1,74 @@
+/*
+ * Minimal reader for SimSo configuration files, shared by the tools that
+ * take one (sched_analysis, simso_tasks).
+ *
+ * SimSo writes flat XML with every value in an attribute, so an element is
+ * found by its name and its attributes by " name=\"".  Each tool is a single
+ * translation unit, so these stay in an unnamed namespace like the rest of
+ * its code.
+ */
+
+#ifndef SIMSO_XML_H
+#define SIMSO_XML_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+/* Value of attribute xName in an element found by prvElements(), "" when it
+is missing. */
+inline std::string prvAttribute( const std::string & xTag, const std::string & xName )
+{
+	const std::string xKey = " " + xName + "=\"";
+	size_t uxStart = xTag.find( xKey );
+
+	if( uxStart == std::string::npos )
+	{
+		return "";
+	}
+	uxStart += xKey.size();
+
+	std::string xValue = xTag.substr( uxStart, xTag.find( '"', uxStart ) - uxStart );
+
+	/* SimSo only escapes the characters XML requires. */
+	const std::pair< const char *, const char * > xEntities[] = {
+		{ "&lt;", "<" }, { "&gt;", ">" }, { "&quot;", "\"" }, { "&apos;", "'" }, { "&amp;", "&" }
+	};
+	for( const auto & xEntity : xEntities )
+	{
+		for( size_t x = xValue.find( xEntity.first ); x != std::string::npos; x = xValue.find( xEntity.first, x + 1 ) )
+		{
+			xValue.replace( x, std::string( xEntity.first ).size(), xEntity.second );
+		}
+	}
+
+	return xValue;
+}
+/*-----------------------------------------------------------*/
+
+/* Every element with the given name, as the text between '<' and '>'. */
+inline std::vector< std::string > prvElements( const std::string & xXml, const std::string & xName )
+{
+	std::vector< std::string > xFound;
+	const std::string xOpen = "<" + xName;
+
+	for( size_t x = xXml.find( xOpen ); x != std::string::npos; x = xXml.find( xOpen, x + 1 ) )
+	{
+		const char cNext = xXml[ x + xOpen.size() ];
+
+		if( ( cNext == ' ' ) || ( cNext == '\t' ) || ( cNext == '\r' ) || ( cNext == '\n' ) || ( cNext == '/' ) || ( cNext == '>' ) )
+		{
+			const size_t uxEnd = xXml.find( '>', x );
+			xFound.push_back( " " + xXml.substr( x + xOpen.size(), uxEnd - x - xOpen.size() ) );
+		}
+	}
+
+	return xFound;
+}
+
+} /* namespace */
+
+#endif /* SIMSO_XML_H */
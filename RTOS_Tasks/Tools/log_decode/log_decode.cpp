@@ -0,0 +1,321 @@
+/*
+ * log_decode: prints the binary log sent by the firmware (EDF/log_ring.h)
+ * as text.
+ *
+ * The format strings are not sent: they are read from the log_formats.h the
+ * firmware was built with, where the n-th logFORMAT() line is format ID n.
+ *
+ * Capture the UART1 stream to a file with any terminal that can log raw
+ * bytes, then:
+ *
+ *     g++ -O2 -std=c++17 log_decode.cpp -o log_decode
+ *     ./log_decode "../../Final Project/ARM7_LPC2129_Keil_RVDS/EDF/log_formats.h" capture.bin
+ *
+ * Every line starts with the time in ms since the first record.
+ *
+ * Options:
+ *     --hz N          Timer1 rate, default 59940 (60 MHz / (T1PR + 1), T1PR = 1000)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/* Must match EDF/log_ring.h. */
+const uint8_t logSYNC_HEADER = 0xff;
+const size_t logSYNC_BYTES = 9;
+const unsigned logMAX_ARGS = 3;
+const unsigned logMAX_VARINT_BYTES = 5;
+
+struct LogFormat
+{
+	std::string xName;
+	std::string xFormat;
+};
+
+/* Reads the logFORMAT( name, "format" ) lines, ignoring comments. */
+bool prvLoadFormats( const std::string & xPath, std::vector< LogFormat > & xFormats )
+{
+	std::ifstream xIn( xPath );
+	if( !xIn )
+	{
+		return false;
+	}
+
+	std::stringstream xBuffer;
+	xBuffer << xIn.rdbuf();
+	std::string xText = std::regex_replace( xBuffer.str(), std::regex( "/\\*[^]*?\\*/|//[^\\n]*" ), " " );
+
+	std::regex xLine( "logFORMAT\\s*\\(\\s*(\\w+)\\s*,\\s*\"((?:[^\"\\\\]|\\\\.)*)\"\\s*\\)" );
+	for( std::sregex_iterator xIt( xText.begin(), xText.end(), xLine ), xEnd; xIt != xEnd; ++xIt )
+	{
+		std::string xRaw = ( *xIt )[ 2 ], xFormat;
+
+		for( size_t x = 0; x < xRaw.size(); x++ )
+		{
+			if( ( xRaw[ x ] == '\\' ) && ( x + 1 < xRaw.size() ) )
+			{
+				char c = xRaw[ ++x ];
+				xFormat += ( c == 'n' ) ? '\n' : ( c == 't' ) ? '\t' : ( c == 'r' ) ? '\r' : c;
+			}
+			else
+			{
+				xFormat += xRaw[ x ];
+			}
+		}
+
+		xFormats.push_back( { ( *xIt )[ 1 ], xFormat } );
+	}
+
+	return true;
+}
+
+/* printf on 32 bit arguments, with the conversions log_formats.h allows. */
+std::string prvFormat( const std::string & xFormat, const uint32_t * pulArgs, unsigned uxArgs )
+{
+	std::string xOut;
+	unsigned uxNext = 0;
+
+	for( size_t x = 0; x < xFormat.size(); x++ )
+	{
+		if( xFormat[ x ] != '%' )
+		{
+			/* Line ends belong to the output, not to the message. */
+			if( ( xFormat[ x ] != '\r' ) && ( xFormat[ x ] != '\n' ) )
+			{
+				xOut += xFormat[ x ];
+			}
+			continue;
+		}
+
+		std::string xSpec = "%";
+		while( ( ++x < xFormat.size() ) && ( std::string( "-+ #0123456789" ).find( xFormat[ x ] ) != std::string::npos ) )
+		{
+			xSpec += xFormat[ x ];
+		}
+		while( ( x < xFormat.size() ) && ( ( xFormat[ x ] == 'l' ) || ( xFormat[ x ] == 'h' ) ) )
+		{
+			x++;
+		}
+		if( x >= xFormat.size() )
+		{
+			break;
+		}
+
+		char cConversion = xFormat[ x ];
+		char cBuffer[ 64 ];
+
+		if( cConversion == '%' )
+		{
+			xOut += '%';
+			continue;
+		}
+		if( uxNext >= uxArgs )
+		{
+			xOut += "<missing>";
+			continue;
+		}
+
+		uint32_t ulArg = pulArgs[ uxNext++ ];
+		switch( cConversion )
+		{
+			case 'd':
+			case 'i':
+				std::snprintf( cBuffer, sizeof( cBuffer ), ( xSpec + "ld" ).c_str(), ( long ) ( int32_t ) ulArg );
+				break;
+
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+				std::snprintf( cBuffer, sizeof( cBuffer ), ( xSpec + 'l' + cConversion ).c_str(), ( unsigned long ) ulArg );
+				break;
+
+			case 'c':
+				std::snprintf( cBuffer, sizeof( cBuffer ), ( xSpec + 'c' ).c_str(), ( int ) ( ulArg & 0xffU ) );
+				break;
+
+			default:
+				std::snprintf( cBuffer, sizeof( cBuffer ), "<%%%c?>", cConversion );
+				break;
+		}
+		xOut += cBuffer;
+	}
+
+	return xOut;
+}
+
+/* Returns the number of bytes used, 0 when the varint is cut off or too long. */
+size_t prvGetVarint( const std::vector< uint8_t > & xData, size_t uxOffset, uint32_t & ulValue )
+{
+	ulValue = 0;
+
+	for( unsigned x = 0; ( x < logMAX_VARINT_BYTES ) && ( uxOffset + x < xData.size() ); x++ )
+	{
+		ulValue |= ( uint32_t ) ( xData[ uxOffset + x ] & 0x7fU ) << ( 7U * x );
+		if( ( xData[ uxOffset + x ] & 0x80U ) == 0U )
+		{
+			return x + 1U;
+		}
+	}
+
+	return 0;
+}
+
+void prvUsage()
+{
+	std::cerr << "usage: log_decode [--hz N] log_formats.h capture.bin\n";
+}
+
+} /* namespace */
+
+int main( int argc, char ** argv )
+{
+	double dTimerHz = 59940.0;
+	std::vector< std::string > xFiles;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		std::string xArg = argv[ i ];
+
+		if( ( xArg == "--hz" ) && ( i + 1 < argc ) )
+		{
+			dTimerHz = std::atof( argv[ ++i ] );
+		}
+		else
+		{
+			xFiles.push_back( xArg );
+		}
+	}
+
+	if( ( xFiles.size() != 2 ) || ( dTimerHz <= 0.0 ) )
+	{
+		prvUsage();
+		return 2;
+	}
+
+	std::vector< LogFormat > xFormats;
+	if( !prvLoadFormats( xFiles[ 0 ], xFormats ) )
+	{
+		std::cerr << "cannot open " << xFiles[ 0 ] << "\n";
+		return 1;
+	}
+	if( xFormats.empty() )
+	{
+		std::cerr << "no logFORMAT() lines in " << xFiles[ 0 ] << "\n";
+		return 1;
+	}
+
+	std::ifstream xIn( xFiles[ 1 ], std::ios::binary );
+	if( !xIn )
+	{
+		std::cerr << "cannot open " << xFiles[ 1 ] << "\n";
+		return 1;
+	}
+	std::vector< uint8_t > xData( ( std::istreambuf_iterator< char >( xIn ) ), std::istreambuf_iterator< char >() );
+
+	bool xSynced = false, xHaveStart = false;
+	uint32_t ulLast = 0;
+	uint64_t ullNow = 0;
+	uint16_t usLastDropped = 0;
+	size_t uxRecords = 0, uxSyncs = 0, uxSkipped = 0, uxTextBytes = 0;
+	size_t uxOffset = 0;
+
+	while( uxOffset < xData.size() )
+	{
+		uint8_t ucHeader = xData[ uxOffset ];
+
+		if( ucHeader == logSYNC_HEADER )
+		{
+			if( ( uxOffset + logSYNC_BYTES <= xData.size() ) && ( xData[ uxOffset + 1 ] == 'L' ) && ( xData[ uxOffset + 2 ] == 'G' ) )
+			{
+				const uint8_t * p = &xData[ uxOffset + 3 ];
+				uint32_t ulSyncTime = ( uint32_t ) p[ 0 ] | ( ( uint32_t ) p[ 1 ] << 8 ) | ( ( uint32_t ) p[ 2 ] << 16 ) | ( ( uint32_t ) p[ 3 ] << 24 );
+				uint16_t usDropped = ( uint16_t ) ( p[ 4 ] | ( p[ 5 ] << 8 ) );
+
+				if( !xHaveStart )
+				{
+					usLastDropped = usDropped;
+					xHaveStart = true;
+				}
+				else
+				{
+					/* Unwrap T1TC into a 64 bit time line starting at 0. */
+					ullNow += ( uint32_t ) ( ulSyncTime - ulLast );
+				}
+				ulLast = ulSyncTime;
+
+				if( usDropped != usLastDropped )
+				{
+					std::printf( "%12.3f  --- %u records dropped\n", ( double ) ullNow * 1e3 / dTimerHz, ( unsigned ) ( uint16_t ) ( usDropped - usLastDropped ) );
+					usLastDropped = usDropped;
+				}
+
+				xSynced = true;
+				uxSyncs++;
+				uxOffset += logSYNC_BYTES;
+				continue;
+			}
+		}
+		else if( xSynced && ( ( size_t ) ( ucHeader >> 2 ) < xFormats.size() ) )
+		{
+			unsigned uxArgs = ucHeader & 0x03U;
+			uint32_t ulDelta, ulArgs[ logMAX_ARGS ];
+			size_t uxUsed = prvGetVarint( xData, uxOffset + 1, ulDelta );
+			size_t uxEnd = uxOffset + 1 + uxUsed;
+
+			for( unsigned x = 0; ( x < uxArgs ) && ( uxUsed != 0U ); x++ )
+			{
+				uxUsed = prvGetVarint( xData, uxEnd, ulArgs[ x ] );
+				uxEnd += uxUsed;
+			}
+
+			if( uxUsed != 0U )
+			{
+				ullNow += ulDelta;
+				ulLast += ulDelta;
+
+				std::string xText = prvFormat( xFormats[ ucHeader >> 2 ].xFormat, ulArgs, uxArgs );
+				std::printf( "%12.3f  %s\n", ( double ) ullNow * 1e3 / dTimerHz, xText.c_str() );
+
+				/* What the same line costs as text with "\r\n". */
+				uxTextBytes += xText.size() + 2U;
+				uxRecords++;
+				uxOffset = uxEnd;
+				continue;
+			}
+		}
+
+		/* Line noise, a partial capture or an ID missing from the table:
+		skip to the next sync record. */
+		xSynced = false;
+		uxOffset++;
+		uxSkipped++;
+	}
+
+	std::cerr << uxRecords << " records in " << xData.size() << " bytes, " << uxSyncs << " syncs";
+	if( uxRecords != 0U )
+	{
+		char cRatio[ 64 ];
+		std::snprintf( cRatio, sizeof( cRatio ), ", %.2f bytes per record (%.1fx less than the bare text)",
+					   ( double ) xData.size() / ( double ) uxRecords, ( double ) uxTextBytes / ( double ) xData.size() );
+		std::cerr << cRatio;
+	}
+	if( uxSkipped != 0U )
+	{
+		std::cerr << ", " << uxSkipped << " bytes skipped while resynchronising";
+	}
+	std::cerr << "\n";
+
+	return 0;
+}
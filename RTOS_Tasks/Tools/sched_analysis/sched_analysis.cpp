@@ -0,0 +1,825 @@
+/*
+ * sched_analysis: schedulability analysis of a SimSo task set.
+ *
+ * Reads a SimSo configuration file (Types of Schedulars/Simso.xml, Design a
+ * real time system/first_design_SimSo.xml, Final Project/Simso.xml, ...) and
+ * checks it on one processor without simulating:
+ *
+ *  - fixed priority: exact response time analysis, with the level-i busy
+ *    period so that deadlines longer than the period are handled too.
+ *  - EDF: processor demand analysis with QPA for the verdict, and Spuri's
+ *    analysis for the worst case response time of every task.  Spuri's
+ *    analysis walks every job in the busy period once per task, so it is
+ *    skipped, leaving the QPA verdict alone, when that is more than
+ *    analysisMAX_WCRT_STEPS jobs.
+ *
+ * All times are converted to integers in the smallest decimal unit used in
+ * the file, so the results are exact.  Releases are assumed synchronous
+ * (activationDate is ignored), which is the worst case, and sporadic tasks
+ * are analysed at their minimum inter-arrival time.
+ *
+ *     g++ -O2 -std=c++17 sched_analysis.cpp -o sched_analysis
+ *     ./sched_analysis "../../Types of Schedulars/Simso.xml"
+ *
+ * Options:
+ *     --policy P      fp, rm, dm or edf instead of the scheduler in the file.
+ *                     fp uses the priority field, a larger value being a
+ *                     higher priority as in FreeRTOS; rm and dm assign
+ *                     priorities by period and by deadline.
+ *     --wcrt          EDF: compute the response times however long the busy
+ *                     period is.
+ *
+ * The exit status is 0 when the set is schedulable, 1 when it is not and 2
+ * on bad input.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../common/simso_xml.h"
+
+namespace
+{
+
+/* Finer than any SimSo value we have seen, and small enough that the scaled
+times stay far from overflowing 64 bits. */
+const int analysisMAX_DECIMALS = 6;
+
+/* Tasks times jobs in the busy period above which the EDF response times are
+only computed on request.  A step is a heap update, a few hundred ns, so
+this many take a quarter of a second at most. */
+const long double analysisMAX_WCRT_STEPS = 1e6L;
+
+/* Response time of a task that can miss its deadline.  The iteration stops
+as soon as a job passes its deadline, so there is no exact value. */
+const int64_t analysisNO_RESULT = -1;
+
+enum class Policy
+{
+	FixedPriority,
+	RateMonotonic,
+	DeadlineMonotonic,
+	Edf
+};
+
+struct Task
+{
+	std::string xName;
+	std::string xWcet, xPeriod, xDeadline;		/* As written in the file. */
+	int64_t llWcet = 0, llPeriod = 0, llDeadline = 0;
+	long lPriority = 0;
+
+	int64_t llResponse = analysisNO_RESULT;	/* Worst case response time, scaled. */
+};
+
+struct TaskSet
+{
+	std::string xScheduler;
+	unsigned uxProcessors = 0;
+	std::vector< Task > xTasks;
+	int64_t llScale = 1;						/* Scaled units per ms. */
+	int iDecimals = 0;
+	long double ldSkippedSteps = 0.0L;		/* Non-zero when the EDF response times were skipped. */
+};
+
+/*-----------------------------------------------------------*/
+
+int prvDecimals( const std::string & xValue )
+{
+	const size_t uxDot = xValue.find( '.' );
+
+	return ( uxDot == std::string::npos ) ? 0 : ( int ) ( xValue.size() - uxDot - 1 );
+}
+/*-----------------------------------------------------------*/
+
+/* Plain decimal to an integer count of 10^-iDecimals units, or -1. */
+int64_t prvScaled( const std::string & xValue, int iDecimals )
+{
+	int64_t llValue = 0;
+	int iFraction = -1;
+
+	if( xValue.empty() )
+	{
+		return -1;
+	}
+
+	for( char c : xValue )
+	{
+		if( c == '.' )
+		{
+			if( iFraction >= 0 )
+			{
+				return -1;
+			}
+			iFraction = 0;
+		}
+		else if( ( c >= '0' ) && ( c <= '9' ) )
+		{
+			if( iFraction >= 0 )
+			{
+				iFraction++;
+			}
+			if( iFraction <= iDecimals )
+			{
+				llValue = llValue * 10 + ( c - '0' );
+			}
+		}
+		else
+		{
+			return -1;
+		}
+	}
+
+	for( int x = std::max( iFraction, 0 ); x < iDecimals; x++ )
+	{
+		llValue *= 10;
+	}
+
+	return llValue;
+}
+/*-----------------------------------------------------------*/
+
+std::string prvFormat( int64_t llValue, const TaskSet & xSet )
+{
+	char cBuffer[ 48 ];
+
+	if( xSet.iDecimals == 0 )
+	{
+		std::snprintf( cBuffer, sizeof( cBuffer ), "%lld", ( long long ) llValue );
+	}
+	else
+	{
+		std::snprintf( cBuffer, sizeof( cBuffer ), "%lld.%0*lld", ( long long ) ( llValue / xSet.llScale ), xSet.iDecimals,
+					   ( long long ) ( llValue % xSet.llScale ) );
+	}
+
+	return cBuffer;
+}
+/*-----------------------------------------------------------*/
+
+int64_t prvCeilDiv( int64_t a, int64_t b )
+{
+	return ( a + b - 1 ) / b;
+}
+/*-----------------------------------------------------------*/
+
+/* Floor division that is also right for negative numerators. */
+int64_t prvFloorDiv( int64_t a, int64_t b )
+{
+	return ( a >= 0 ) ? ( a / b ) : -( ( -a + b - 1 ) / b );
+}
+/*-----------------------------------------------------------*/
+
+bool prvLoad( const std::string & xPath, TaskSet & xSet )
+{
+	std::ifstream xIn( xPath );
+	if( !xIn )
+	{
+		std::cerr << "cannot open " << xPath << "\n";
+		return false;
+	}
+	const std::string xXml( ( std::istreambuf_iterator< char >( xIn ) ), std::istreambuf_iterator< char >() );
+
+	const std::vector< std::string > xSched = prvElements( xXml, "sched" );
+	if( !xSched.empty() )
+	{
+		xSet.xScheduler = prvAttribute( xSched[ 0 ], "class" );
+	}
+	xSet.uxProcessors = ( unsigned ) prvElements( xXml, "processor" ).size();
+
+	for( const std::string & xTag : prvElements( xXml, "task" ) )
+	{
+		Task xTask;
+
+		xTask.xName = prvAttribute( xTag, "name" );
+		xTask.xWcet = prvAttribute( xTag, "WCET" );
+		xTask.xPeriod = prvAttribute( xTag, "period" );
+		xTask.xDeadline = prvAttribute( xTag, "deadline" );
+		xTask.lPriority = std::strtol( prvAttribute( xTag, "priority" ).c_str(), nullptr, 10 );
+
+		if( xTask.xName.empty() )
+		{
+			xTask.xName = "task " + prvAttribute( xTag, "id" );
+		}
+		if( xTask.xDeadline.empty() )
+		{
+			xTask.xDeadline = xTask.xPeriod;
+		}
+
+		for( const std::string * pxValue : { &xTask.xWcet, &xTask.xPeriod, &xTask.xDeadline } )
+		{
+			xSet.iDecimals = std::max( xSet.iDecimals, prvDecimals( *pxValue ) );
+		}
+		xSet.xTasks.push_back( xTask );
+	}
+
+	if( xSet.xTasks.empty() )
+	{
+		std::cerr << xPath << ": no tasks\n";
+		return false;
+	}
+	if( xSet.iDecimals > analysisMAX_DECIMALS )
+	{
+		std::cerr << xPath << ": times are limited to " << analysisMAX_DECIMALS << " decimals\n";
+		return false;
+	}
+
+	for( int x = 0; x < xSet.iDecimals; x++ )
+	{
+		xSet.llScale *= 10;
+	}
+
+	for( Task & xTask : xSet.xTasks )
+	{
+		xTask.llWcet = prvScaled( xTask.xWcet, xSet.iDecimals );
+		xTask.llPeriod = prvScaled( xTask.xPeriod, xSet.iDecimals );
+		xTask.llDeadline = prvScaled( xTask.xDeadline, xSet.iDecimals );
+
+		if( ( xTask.llWcet <= 0 ) || ( xTask.llPeriod <= 0 ) || ( xTask.llDeadline <= 0 ) )
+		{
+			std::cerr << xPath << ": " << xTask.xName << ": WCET, period and deadline must be positive decimals\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+/*-----------------------------------------------------------*/
+
+/* Least common multiple of the periods, or 0 if it does not fit 64 bits. */
+uint64_t prvHyperperiod( const TaskSet & xSet )
+{
+	uint64_t ullLcm = 1;
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		uint64_t a = ullLcm, b = ( uint64_t ) xTask.llPeriod;
+
+		while( b != 0U )
+		{
+			const uint64_t t = a % b;
+			a = b;
+			b = t;
+		}
+
+		if( __builtin_mul_overflow( ullLcm / a, ( uint64_t ) xTask.llPeriod, &ullLcm ) )
+		{
+			return 0;
+		}
+	}
+
+	return ullLcm;
+}
+/*-----------------------------------------------------------*/
+
+/* True when the utilisation of the tasks is above 1.  The sum is kept as a
+reduced fraction so that a set at exactly U = 1 is not pushed over by
+rounding; only if its denominator outgrows 128 bits does it fall back to
+long double, and then a sum within rounding of 1 counts as over, since the
+busy period of an overloaded set never ends. */
+bool prvOverloaded( const std::vector< const Task * > & xTasks )
+{
+	typedef unsigned __int128 Wide;
+
+	auto xGcd = []( Wide a, Wide b )
+	{
+		while( b != 0U )
+		{
+			const Wide t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	};
+
+	Wide xNumerator = 0, xDenominator = 1;
+	long double ldUtilisation = 0.0L;
+	bool xExact = true;
+
+	for( const Task * pxTask : xTasks )
+	{
+		const Wide xWcet = ( Wide ) pxTask->llWcet, xPeriod = ( Wide ) pxTask->llPeriod;
+
+		ldUtilisation += ( long double ) pxTask->llWcet / ( long double ) pxTask->llPeriod;
+
+		if( xExact )
+		{
+			const Wide xCommon = xGcd( xDenominator, xPeriod );
+			Wide xScaled, xAdded, xNext;
+
+			if( __builtin_mul_overflow( xNumerator, xPeriod / xCommon, &xScaled ) ||
+				__builtin_mul_overflow( xWcet, xDenominator / xCommon, &xAdded ) ||
+				__builtin_add_overflow( xScaled, xAdded, &xScaled ) ||
+				__builtin_mul_overflow( xDenominator / xCommon, xPeriod, &xNext ) )
+			{
+				xExact = false;
+				continue;
+			}
+
+			const Wide xReduce = xGcd( xScaled, xNext );
+			xNumerator = xScaled / xReduce;
+			xDenominator = xNext / xReduce;
+
+			/* Every term is positive, so once over it stays over. */
+			if( xNumerator > xDenominator )
+			{
+				return true;
+			}
+		}
+	}
+
+	return xExact ? false : ( ldUtilisation > 1.0L - 1e-15L );
+}
+/*-----------------------------------------------------------*/
+
+/* Fixed point of the synchronous busy period, which ends when the tasks are
+not overloaded. */
+int64_t prvBusyPeriod( const std::vector< const Task * > & xTasks )
+{
+	int64_t llLength = 0, llNext = 0;
+
+	for( const Task * pxTask : xTasks )
+	{
+		llNext += pxTask->llWcet;
+	}
+
+	while( llNext != llLength )
+	{
+		llLength = llNext;
+		llNext = 0;
+		for( const Task * pxTask : xTasks )
+		{
+			llNext += prvCeilDiv( llLength, pxTask->llPeriod ) * pxTask->llWcet;
+		}
+	}
+
+	return llLength;
+}
+/*-----------------------------------------------------------*/
+
+/* Response time analysis, each task against the ones of higher or equal
+priority (FreeRTOS time slices equal priorities, so any of them may run
+first).  All jobs in the level-i busy period are checked, which makes the
+result exact for deadlines longer than the period as well. */
+void prvAnalyseFixedPriority( TaskSet & xSet, Policy ePolicy )
+{
+	auto xHigherOrEqual = [ ePolicy ]( const Task & a, const Task & b )
+	{
+		switch( ePolicy )
+		{
+			case Policy::RateMonotonic:		return a.llPeriod <= b.llPeriod;
+			case Policy::DeadlineMonotonic:	return a.llDeadline <= b.llDeadline;
+			default:						return a.lPriority >= b.lPriority;
+		}
+	};
+
+	for( Task & xTask : xSet.xTasks )
+	{
+		std::vector< const Task * > xInterfering;
+		std::vector< const Task * > xLevel{ &xTask };
+
+		for( const Task & xOther : xSet.xTasks )
+		{
+			if( ( &xOther != &xTask ) && xHigherOrEqual( xOther, xTask ) )
+			{
+				xInterfering.push_back( &xOther );
+				xLevel.push_back( &xOther );
+			}
+		}
+
+		xTask.llResponse = analysisNO_RESULT;
+		if( prvOverloaded( xLevel ) )
+		{
+			continue;
+		}
+
+		const int64_t llJobs = prvCeilDiv( prvBusyPeriod( xLevel ), xTask.llPeriod );
+		int64_t llWorst = 0;
+
+		for( int64_t q = 0; q < llJobs; q++ )
+		{
+			int64_t llFinish = 0, llNext = ( q + 1 ) * xTask.llWcet;
+
+			for( const Task * pxOther : xInterfering )
+			{
+				llNext += pxOther->llWcet;
+			}
+
+			while( ( llNext != llFinish ) && ( llNext - q * xTask.llPeriod <= xTask.llDeadline ) )
+			{
+				llFinish = llNext;
+				llNext = ( q + 1 ) * xTask.llWcet;
+				for( const Task * pxOther : xInterfering )
+				{
+					llNext += prvCeilDiv( llFinish, pxOther->llPeriod ) * pxOther->llWcet;
+				}
+			}
+
+			if( llNext - q * xTask.llPeriod > xTask.llDeadline )
+			{
+				llWorst = analysisNO_RESULT;
+				break;
+			}
+			llWorst = std::max( llWorst, llNext - q * xTask.llPeriod );
+		}
+
+		xTask.llResponse = llWorst;
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Processor demand of jobs with release and deadline inside [0, t]. */
+int64_t prvDemand( const TaskSet & xSet, int64_t t )
+{
+	int64_t llDemand = 0;
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		if( t >= xTask.llDeadline )
+		{
+			llDemand += ( ( t - xTask.llDeadline ) / xTask.llPeriod + 1 ) * xTask.llWcet;
+		}
+	}
+
+	return llDemand;
+}
+/*-----------------------------------------------------------*/
+
+/* The latest absolute deadline strictly before t, or 0 if there is none. */
+int64_t prvDeadlineBefore( const TaskSet & xSet, int64_t t )
+{
+	int64_t llLatest = 0;
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		if( t > xTask.llDeadline )
+		{
+			llLatest = std::max( llLatest, ( ( t - xTask.llDeadline - 1 ) / xTask.llPeriod ) * xTask.llPeriod + xTask.llDeadline );
+		}
+	}
+
+	return llLatest;
+}
+/*-----------------------------------------------------------*/
+
+/* Quick Processor-demand Analysis (Zhang and Burns): walks the deadlines
+backwards from the end of the first busy period, jumping straight to h(t)
+where the demand leaves room, so only a handful of points are visited. */
+bool prvEdfFeasible( const TaskSet & xSet, int64_t llBusyPeriod )
+{
+	int64_t llMinDeadline = xSet.xTasks[ 0 ].llDeadline;
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		llMinDeadline = std::min( llMinDeadline, xTask.llDeadline );
+	}
+
+	int64_t t = prvDeadlineBefore( xSet, llBusyPeriod + 1 );
+	int64_t h = prvDemand( xSet, t );
+
+	while( ( h <= t ) && ( h > llMinDeadline ) )
+	{
+		t = ( h < t ) ? h : prvDeadlineBefore( xSet, t );
+		h = prvDemand( xSet, t );
+	}
+
+	return h <= llMinDeadline;
+}
+/*-----------------------------------------------------------*/
+
+/* Spuri's worst case response time of one task under EDF: a job of the
+task released at a, with every other task released at 0, for every a in
+the busy period where another deadline coincides with the job's own.
+The busy period length
+
+    L(a) = ( 1 + floor( a / Ti ) ) Ci
+           + sum over j != i of min( ceil( L / Tj ), 1 + floor( ( a + Di - Dj ) / Tj ) ) Cj
+
+only grows with a, so rather than iterating the sum for every offset the
+job counts are kept per task and bumped as L passes a period or a passes a
+deadline, with two heaps giving the next of either.  That keeps the work
+proportional to the number of jobs in the busy period. */
+int64_t prvEdfResponseTime( const TaskSet & xSet, size_t uxTask, int64_t llBusyPeriod )
+{
+	typedef std::pair< int64_t, size_t > Event;
+	typedef std::priority_queue< Event, std::vector< Event >, std::greater< Event > > EventQueue;
+
+	const Task & xTask = xSet.xTasks[ uxTask ];
+	const size_t uxCount = xSet.xTasks.size();
+	std::vector< int64_t > xJobs( uxCount, 0 ), xLimit( uxCount, 0 );
+	std::vector< bool > xAtLimit( uxCount, false );
+	EventQueue xPeriods;		/* L at which a task's count may grow. */
+	EventQueue xDeadlines;		/* a at which a task's limit grows. */
+	int64_t llOwn = xTask.llWcet, llOthers = 0;
+
+	for( size_t j = 0; j < uxCount; j++ )
+	{
+		const Task & xOther = xSet.xTasks[ j ];
+
+		if( j == uxTask )
+		{
+			xDeadlines.push( Event( xTask.llPeriod, j ) );
+			continue;
+		}
+
+		xLimit[ j ] = std::max< int64_t >( 0, prvFloorDiv( xTask.llDeadline - xOther.llDeadline, xOther.llPeriod ) + 1 );
+		xJobs[ j ] = std::min< int64_t >( 1, xLimit[ j ] );
+		llOthers += xJobs[ j ] * xOther.llWcet;
+
+		if( xJobs[ j ] < xLimit[ j ] )
+		{
+			xPeriods.push( Event( xJobs[ j ] * xOther.llPeriod, j ) );
+		}
+		else
+		{
+			xAtLimit[ j ] = true;
+		}
+		xDeadlines.push( Event( xLimit[ j ] * xOther.llPeriod + xOther.llDeadline - xTask.llDeadline, j ) );
+	}
+
+	int64_t a = 0, llEnd = 0, llWorst = xTask.llWcet;
+
+	for( ;; )
+	{
+		/* Fixed point of L(a), continuing from the one for the previous a. */
+		while( llOwn + llOthers > llEnd )
+		{
+			llEnd = llOwn + llOthers;
+
+			while( !xPeriods.empty() && ( xPeriods.top().first < llEnd ) )
+			{
+				const size_t j = xPeriods.top().second;
+				const Task & xOther = xSet.xTasks[ j ];
+
+				xPeriods.pop();
+				xJobs[ j ]++;
+				llOthers += xOther.llWcet;
+
+				if( xJobs[ j ] < xLimit[ j ] )
+				{
+					xPeriods.push( Event( xJobs[ j ] * xOther.llPeriod, j ) );
+				}
+				else
+				{
+					xAtLimit[ j ] = true;
+				}
+			}
+		}
+
+		llWorst = std::max( llWorst, llEnd - a );
+
+		if( xDeadlines.empty() || ( xDeadlines.top().first >= llBusyPeriod ) )
+		{
+			break;
+		}
+
+		/* Next offset, raising the limit of every task with a deadline there. */
+		a = xDeadlines.top().first;
+		while( !xDeadlines.empty() && ( xDeadlines.top().first == a ) )
+		{
+			const size_t j = xDeadlines.top().second;
+			const Task & xOther = xSet.xTasks[ j ];
+
+			xDeadlines.pop();
+			xDeadlines.push( Event( a + xOther.llPeriod, j ) );
+
+			if( j == uxTask )
+			{
+				llOwn += xTask.llWcet;
+				continue;
+			}
+
+			xLimit[ j ]++;
+			if( xAtLimit[ j ] )
+			{
+				if( llEnd > xJobs[ j ] * xOther.llPeriod )
+				{
+					xJobs[ j ]++;
+					llOthers += xOther.llWcet;
+				}
+				else
+				{
+					xAtLimit[ j ] = false;
+					xPeriods.push( Event( xJobs[ j ] * xOther.llPeriod, j ) );
+				}
+			}
+		}
+	}
+
+	return llWorst;
+}
+/*-----------------------------------------------------------*/
+
+/* QPA verdict under EDF, then the worst case response times, which agree
+with it, unless there are too many jobs to go through and xAlways is false. */
+bool prvAnalyseEdf( TaskSet & xSet, bool xAlways )
+{
+	std::vector< const Task * > xAll;
+
+	for( Task & xTask : xSet.xTasks )
+	{
+		xAll.push_back( &xTask );
+		xTask.llResponse = analysisNO_RESULT;
+	}
+
+	if( prvOverloaded( xAll ) )
+	{
+		return false;
+	}
+
+	const int64_t llBusyPeriod = prvBusyPeriod( xAll );
+	const bool xFeasible = prvEdfFeasible( xSet, llBusyPeriod );
+	long double ldSteps = 0.0L;
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		ldSteps += ( long double ) prvCeilDiv( llBusyPeriod, xTask.llPeriod ) * ( long double ) xSet.xTasks.size();
+	}
+
+	if( !xAlways && ( ldSteps > analysisMAX_WCRT_STEPS ) )
+	{
+		xSet.ldSkippedSteps = ldSteps;
+		return xFeasible;
+	}
+
+	for( size_t x = 0; x < xSet.xTasks.size(); x++ )
+	{
+		Task & xTask = xSet.xTasks[ x ];
+		const int64_t llResponse = prvEdfResponseTime( xSet, x, llBusyPeriod );
+
+		xTask.llResponse = ( llResponse <= xTask.llDeadline ) ? llResponse : analysisNO_RESULT;
+	}
+
+	return xFeasible;
+}
+/*-----------------------------------------------------------*/
+
+void prvUsage()
+{
+	std::cerr << "usage: sched_analysis [--policy fp|rm|dm|edf] [--wcrt] simso.xml\n";
+}
+
+} /* namespace */
+
+int main( int argc, char ** argv )
+{
+	std::string xPolicyName, xFile;
+	bool xAlwaysWcrt = false;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		std::string xArg = argv[ i ];
+
+		if( ( xArg == "--policy" ) && ( i + 1 < argc ) )
+		{
+			xPolicyName = argv[ ++i ];
+		}
+		else if( xArg == "--wcrt" )
+		{
+			xAlwaysWcrt = true;
+		}
+		else if( xFile.empty() )
+		{
+			xFile = xArg;
+		}
+		else
+		{
+			prvUsage();
+			return 2;
+		}
+	}
+
+	TaskSet xSet;
+	if( xFile.empty() )
+	{
+		prvUsage();
+		return 2;
+	}
+	if( !prvLoad( xFile, xSet ) )
+	{
+		return 2;
+	}
+
+	/* Default to the scheduler class in the file, e.g. simso.schedulers.EDF. */
+	if( xPolicyName.empty() )
+	{
+		const std::string xClass = xSet.xScheduler.substr( xSet.xScheduler.rfind( '.' ) + 1 );
+
+		if( xClass.find( "EDF" ) != std::string::npos )
+		{
+			xPolicyName = "edf";
+		}
+		else if( xClass.find( "RM" ) != std::string::npos )
+		{
+			xPolicyName = "rm";
+		}
+		else if( xClass.find( "DM" ) != std::string::npos )
+		{
+			xPolicyName = "dm";
+		}
+		else
+		{
+			xPolicyName = "fp";
+		}
+	}
+
+	const std::map< std::string, Policy > xPolicies = {
+		{ "fp", Policy::FixedPriority }, { "rm", Policy::RateMonotonic },
+		{ "dm", Policy::DeadlineMonotonic }, { "edf", Policy::Edf }
+	};
+	if( xPolicies.count( xPolicyName ) == 0 )
+	{
+		prvUsage();
+		return 2;
+	}
+	const Policy ePolicy = xPolicies.at( xPolicyName );
+
+	if( xSet.uxProcessors > 1U )
+	{
+		std::cerr << "warning: " << xSet.uxProcessors << " processors in the file, analysing one\n";
+	}
+
+	bool xSchedulable = true;
+	if( ePolicy == Policy::Edf )
+	{
+		xSchedulable = prvAnalyseEdf( xSet, xAlwaysWcrt );
+	}
+	else
+	{
+		prvAnalyseFixedPriority( xSet, ePolicy );
+	}
+
+	double dUtilisation = 0.0;
+	for( const Task & xTask : xSet.xTasks )
+	{
+		dUtilisation += ( double ) xTask.llWcet / ( double ) xTask.llPeriod;
+	}
+
+	const uint64_t ullHyperperiod = prvHyperperiod( xSet );
+	std::string xHyperperiod = "beyond 64 bits";
+	if( ullHyperperiod != 0U )
+	{
+		xHyperperiod = prvFormat( ( int64_t ) ullHyperperiod, xSet ) + " ms";
+	}
+
+	std::printf( "policy %s (%s), %zu tasks, U = %.4f, hyperperiod %s\n\n", xPolicyName.c_str(),
+				 xSet.xScheduler.empty() ? "no scheduler in file" : xSet.xScheduler.c_str(),
+				 xSet.xTasks.size(), dUtilisation, xHyperperiod.c_str() );
+	std::printf( "%-16s %10s %10s %10s %8s %10s %10s %12s  %s\n",
+				 "task", "WCET", "period", "deadline", "priority", "WCRT", "slack", "jobs/hyper", "result" );
+
+	for( const Task & xTask : xSet.xTasks )
+	{
+		std::string xJobs = "-";
+		if( ullHyperperiod != 0U )
+		{
+			xJobs = std::to_string( ullHyperperiod / ( uint64_t ) xTask.llPeriod );
+		}
+
+		std::string xPriority = "-";
+		if( ePolicy == Policy::FixedPriority )
+		{
+			xPriority = std::to_string( xTask.lPriority );
+		}
+
+		const bool xMeets = ( xTask.llResponse != analysisNO_RESULT );
+
+		if( xSet.ldSkippedSteps != 0.0L )
+		{
+			std::printf( "%-16s %10s %10s %10s %8s %10s %10s %12s  %s\n", xTask.xName.c_str(),
+						 prvFormat( xTask.llWcet, xSet ).c_str(), prvFormat( xTask.llPeriod, xSet ).c_str(),
+						 prvFormat( xTask.llDeadline, xSet ).c_str(), xPriority.c_str(), "-", "-",
+						 xJobs.c_str(), xSchedulable ? "ok" : "-" );
+			continue;
+		}
+
+		xSchedulable = xSchedulable && xMeets;
+
+		std::printf( "%-16s %10s %10s %10s %8s %10s %10s %12s  %s\n", xTask.xName.c_str(),
+					 prvFormat( xTask.llWcet, xSet ).c_str(), prvFormat( xTask.llPeriod, xSet ).c_str(),
+					 prvFormat( xTask.llDeadline, xSet ).c_str(), xPriority.c_str(),
+					 xMeets ? prvFormat( xTask.llResponse, xSet ).c_str() : "> D",
+					 xMeets ? prvFormat( xTask.llDeadline - xTask.llResponse, xSet ).c_str() : "-",
+					 xJobs.c_str(), xMeets ? "ok" : "MISS" );
+	}
+
+	if( xSet.ldSkippedSteps != 0.0L )
+	{
+		std::printf( "\nresponse times skipped, %.3Lg steps of Spuri's analysis; --wcrt computes them\n",
+					 xSet.ldSkippedSteps );
+	}
+
+	std::printf( "\n%s\n", xSchedulable ? "schedulable" : "NOT schedulable" );
+
+	return xSchedulable ? 0 : 1;
+}
@@ -0,0 +1,389 @@
+/*
+ * simso_tasks: generates the firmware task table header (simso_tasks.h, rows
+ * of the PeriodicTaskConfig_t type from EDF/task_table.h) from the <tasks>
+ * block of a SimSo configuration file, so the task set is written once and
+ * the analysed model and the firmware cannot drift apart.
+ *
+ * The output is a header holding a constant PeriodicTaskConfig_t array and
+ * an enum of task indices with their count, simsoNUMBER_OF_TASKS, as a macro
+ * for the capacity checks; it is included by the one source file that calls
+ * xTaskTableCreate().  Nothing is parsed or allocated at run time.
+ *
+ *     g++ -O2 -std=c++17 simso_tasks.cpp -o simso_tasks
+ *     ./simso_tasks "../../Final Project/Simso.xml" "../../Final Project/ARM7_LPC2129_Keil_RVDS/simso_tasks.h"
+ *
+ * SimSo times are in ms.  Periods and deadlines must be whole ms (one tick),
+ * WCETs whole us.  Tasks get the priority field of the file when it has
+ * one, otherwise --priority.  Task n drives probe pin IO0 PIN3 + n, the same
+ * pin the task monitor would give its slot, up to PIN10.
+ *
+ * Options:
+ *     --entry FUNC            job body of every task, default vPeriodicJob
+ *     --entry-for NAME=FUNC   job body of the task called NAME
+ *     --stack N               stack depth in words, default 100
+ *     --priority N            priority of tasks without one, default 1
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../common/simso_xml.h"
+
+namespace
+{
+
+const char * const pcFIRST_PROBE_PIN = "PIN3";
+const unsigned uxNUMBER_OF_PROBE_PINS = 8;		/* PIN3 to PIN10. */
+
+struct Task
+{
+	std::string xName;
+	std::string xIdentifier;
+	std::string xEntry;
+	uint64_t ullPeriodMs = 0, ullDeadlineMs = 0, ullWcetUs = 0;
+	long lPriority = 0;
+};
+
+/*-----------------------------------------------------------*/
+
+/* Decimal ms to a whole number of 10^-iDecimals ms; false if it is not one. */
+bool prvScaled( const std::string & xValue, int iDecimals, uint64_t & ullResult )
+{
+	int iFraction = -1;
+
+	ullResult = 0;
+	if( xValue.empty() )
+	{
+		return false;
+	}
+
+	for( char c : xValue )
+	{
+		if( ( c == '.' ) && ( iFraction < 0 ) )
+		{
+			iFraction = 0;
+		}
+		else if( ( c >= '0' ) && ( c <= '9' ) )
+		{
+			if( iFraction >= 0 )
+			{
+				iFraction++;
+			}
+
+			if( iFraction > iDecimals )
+			{
+				/* Finer than the unit: only zeros are acceptable. */
+				if( c != '0' )
+				{
+					return false;
+				}
+			}
+			else
+			{
+				ullResult = ullResult * 10U + ( uint64_t ) ( c - '0' );
+			}
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	for( int x = ( iFraction < 0 ) ? 0 : std::min( iFraction, iDecimals ); x < iDecimals; x++ )
+	{
+		ullResult *= 10U;
+	}
+
+	return true;
+}
+/*-----------------------------------------------------------*/
+
+/* "TASK T1" -> "TASK_T1", usable after the simso prefix of the enum. */
+std::string prvIdentifier( const std::string & xName )
+{
+	std::string xIdentifier;
+
+	for( char c : xName )
+	{
+		if( ( ( c >= 'a' ) && ( c <= 'z' ) ) )
+		{
+			xIdentifier += ( char ) ( c - 'a' + 'A' );
+		}
+		else if( ( ( c >= 'A' ) && ( c <= 'Z' ) ) || ( ( c >= '0' ) && ( c <= '9' ) ) )
+		{
+			xIdentifier += c;
+		}
+		else if( xIdentifier.empty() || ( xIdentifier.back() != '_' ) )
+		{
+			xIdentifier += '_';
+		}
+	}
+
+	while( !xIdentifier.empty() && ( xIdentifier.back() == '_' ) )
+	{
+		xIdentifier.pop_back();
+	}
+
+	return xIdentifier;
+}
+/*-----------------------------------------------------------*/
+
+/* xText as the body of a C string literal. */
+std::string prvCString( const std::string & xText )
+{
+	std::string xLiteral;
+
+	for( char c : xText )
+	{
+		if( ( c == '"' ) || ( c == '\\' ) )
+		{
+			xLiteral += '\\';
+			xLiteral += c;
+		}
+		else if( ( unsigned char ) c < 0x20U )
+		{
+			char cOctal[ 5 ];
+
+			std::snprintf( cOctal, sizeof( cOctal ), "\\%03o", ( unsigned ) c );
+			xLiteral += cOctal;
+		}
+		else
+		{
+			xLiteral += c;
+		}
+	}
+
+	return xLiteral;
+}
+/*-----------------------------------------------------------*/
+
+std::string prvBaseName( const std::string & xPath )
+{
+	const size_t uxSlash = xPath.find_last_of( "/\\" );
+
+	return ( uxSlash == std::string::npos ) ? xPath : xPath.substr( uxSlash + 1 );
+}
+/*-----------------------------------------------------------*/
+
+void prvUsage()
+{
+	std::cerr << "usage: simso_tasks [--entry FUNC] [--entry-for NAME=FUNC]... [--stack N] [--priority N] simso.xml [out.h]\n";
+}
+
+} /* namespace */
+
+int main( int argc, char ** argv )
+{
+	std::string xDefaultEntry = "vPeriodicJob";
+	std::map< std::string, std::string > xEntries;
+	unsigned long ulStack = 100, ulDefaultPriority = 1;
+	std::vector< std::string > xFiles;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		std::string xArg = argv[ i ];
+
+		if( ( xArg == "--entry" ) && ( i + 1 < argc ) )
+		{
+			xDefaultEntry = argv[ ++i ];
+		}
+		else if( ( xArg == "--entry-for" ) && ( i + 1 < argc ) )
+		{
+			std::string xValue = argv[ ++i ];
+			size_t uxEquals = xValue.rfind( '=' );
+			if( uxEquals == std::string::npos )
+			{
+				prvUsage();
+				return 2;
+			}
+			xEntries[ xValue.substr( 0, uxEquals ) ] = xValue.substr( uxEquals + 1 );
+		}
+		else if( ( xArg == "--stack" ) && ( i + 1 < argc ) )
+		{
+			ulStack = std::strtoul( argv[ ++i ], nullptr, 10 );
+		}
+		else if( ( xArg == "--priority" ) && ( i + 1 < argc ) )
+		{
+			ulDefaultPriority = std::strtoul( argv[ ++i ], nullptr, 10 );
+		}
+		else
+		{
+			xFiles.push_back( xArg );
+		}
+	}
+
+	if( xFiles.empty() || ( xFiles.size() > 2 ) || ( ulStack == 0U ) || ( ulStack > 0xffffU ) )
+	{
+		prvUsage();
+		return 2;
+	}
+
+	std::ifstream xIn( xFiles[ 0 ] );
+	if( !xIn )
+	{
+		std::cerr << "cannot open " << xFiles[ 0 ] << "\n";
+		return 1;
+	}
+	const std::string xXml( ( std::istreambuf_iterator< char >( xIn ) ), std::istreambuf_iterator< char >() );
+
+	std::vector< Task > xTasks;
+	std::set< std::string > xIdentifiers;
+	long lMaxPriority = 0;
+
+	for( const std::string & xTag : prvElements( xXml, "task" ) )
+	{
+		Task xTask;
+		std::string xDeadline = prvAttribute( xTag, "deadline" );
+		std::string xPriority = prvAttribute( xTag, "priority" );
+
+		xTask.xName = prvAttribute( xTag, "name" );
+		if( xTask.xName.empty() )
+		{
+			xTask.xName = "Task" + prvAttribute( xTag, "id" );
+		}
+		if( xDeadline.empty() )
+		{
+			xDeadline = prvAttribute( xTag, "period" );
+		}
+
+		if( !prvScaled( prvAttribute( xTag, "period" ), 0, xTask.ullPeriodMs ) ||
+			!prvScaled( xDeadline, 0, xTask.ullDeadlineMs ) ||
+			!prvScaled( prvAttribute( xTag, "WCET" ), 3, xTask.ullWcetUs ) ||
+			( xTask.ullPeriodMs == 0U ) || ( xTask.ullDeadlineMs == 0U ) || ( xTask.ullWcetUs == 0U ) )
+		{
+			std::cerr << xFiles[ 0 ] << ": " << xTask.xName << ": period and deadline must be whole ms, WCET whole us\n";
+			return 1;
+		}
+		if( xTask.ullDeadlineMs > xTask.ullPeriodMs )
+		{
+			std::cerr << xFiles[ 0 ] << ": " << xTask.xName << ": deadline longer than the period is not supported by admission control\n";
+			return 1;
+		}
+
+		xTask.lPriority = xPriority.empty() ? ( long ) ulDefaultPriority : std::strtol( xPriority.c_str(), nullptr, 10 );
+		lMaxPriority = std::max( lMaxPriority, xTask.lPriority );
+
+		xTask.xIdentifier = prvIdentifier( xTask.xName );
+		if( xTask.xIdentifier.empty() || !xIdentifiers.insert( xTask.xIdentifier ).second )
+		{
+			std::cerr << xFiles[ 0 ] << ": " << xTask.xName << ": name is empty or not unique as a C identifier\n";
+			return 1;
+		}
+
+		xTask.xEntry = ( xEntries.count( xTask.xName ) != 0 ) ? xEntries[ xTask.xName ] : xDefaultEntry;
+		xTasks.push_back( xTask );
+	}
+
+	if( xTasks.empty() )
+	{
+		std::cerr << xFiles[ 0 ] << ": no tasks\n";
+		return 1;
+	}
+
+	std::string xOutName = ( xFiles.size() == 2 ) ? prvBaseName( xFiles[ 1 ] ) : "simso_tasks.h";
+	std::string xGuard = prvIdentifier( xOutName );
+
+	/* The firmware sources use CRLF line endings, and so does the output. */
+	std::ostringstream xOut;
+	xOut << "/*\n"
+		 << " * Generated by Tools/simso_tasks from " << prvBaseName( xFiles[ 0 ] ) << ", do not edit.\n"
+		 << " *\n"
+		 << " * Periods and deadlines in ms, WCETs in us, as in the SimSo model.  The job\n"
+		 << " * bodies receive their row as pvParameters, see EDF/task_table.h.\n"
+		 << " */\n"
+		 << "\n"
+		 << "#ifndef " << xGuard << "\n"
+		 << "#define " << xGuard << "\n"
+		 << "\n"
+		 << "#include \"task_table.h\"\n"
+		 << "#include \"GPIO.h\"\n"
+		 << "\n";
+
+	std::set< std::string > xDeclared;
+	for( const Task & xTask : xTasks )
+	{
+		if( xDeclared.insert( xTask.xEntry ).second )
+		{
+			xOut << "extern void " << xTask.xEntry << "( void * pvParameters );\n";
+		}
+	}
+
+	xOut << "\n"
+		 << "enum\n"
+		 << "{\n";
+	for( size_t x = 0; x < xTasks.size(); x++ )
+	{
+		xOut << "\tsimso" << xTasks[ x ].xIdentifier << ( ( x + 1 < xTasks.size() ) ? "," : "" ) << "\n";
+	}
+	/* A macro, not the last enumerator: #if sees enumerators as 0. */
+	xOut << "};\n"
+		 << "\n"
+		 << "#define simsoNUMBER_OF_TASKS\t( " << xTasks.size() << " )\n"
+		 << "\n"
+		 << "#if ( simsoNUMBER_OF_TASKS > configEDF_MAX_PERIODIC_TASKS )\n"
+		 << "\t#error The task set needs a larger configEDF_MAX_PERIODIC_TASKS\n"
+		 << "#endif\n"
+		 << "\n"
+		 << "#if ( " << lMaxPriority << " >= configMAX_PRIORITIES )\n"
+		 << "\t#error The task set needs a larger configMAX_PRIORITIES\n"
+		 << "#endif\n"
+		 << "\n"
+		 << "static const PeriodicTaskConfig_t xSimsoTasks[ simsoNUMBER_OF_TASKS ] =\n"
+		 << "{\n"
+		 << "\t/* Entry, name, stack, priority, period, deadline, WCET us, probe pin. */\n";
+
+	for( size_t x = 0; x < xTasks.size(); x++ )
+	{
+		const Task & xTask = xTasks[ x ];
+		std::string xProbe = "0";
+
+		if( x < uxNUMBER_OF_PROBE_PINS )
+		{
+			xProbe = "( 1UL << ( " + std::string( pcFIRST_PROBE_PIN ) + " + " + std::to_string( x ) + " ) )";
+		}
+
+		xOut << "\t{ " << xTask.xEntry << ", \"" << prvCString( xTask.xName ) << "\", " << ulStack << ", " << xTask.lPriority
+			 << ", pdMS_TO_TICKS( " << xTask.ullPeriodMs << " ), pdMS_TO_TICKS( " << xTask.ullDeadlineMs << " ), "
+			 << xTask.ullWcetUs << "UL, " << xProbe << " }" << ( ( x + 1 < xTasks.size() ) ? "," : "" ) << "\n";
+	}
+
+	xOut << "};\n"
+		 << "\n"
+		 << "#endif /* " << xGuard << " */\n";
+
+	std::string xText;
+	for( char c : xOut.str() )
+	{
+		if( c == '\n' )
+		{
+			xText += '\r';
+		}
+		xText += c;
+	}
+
+	if( xFiles.size() == 2 )
+	{
+		std::ofstream xFile( xFiles[ 1 ], std::ios::binary );
+		if( !( xFile << xText ) )
+		{
+			std::cerr << "cannot write " << xFiles[ 1 ] << "\n";
+			return 1;
+		}
+	}
+	else
+	{
+		std::cout << xText;
+	}
+
+	return 0;
+}
@@ -0,0 +1,353 @@
+/*
+ * trace_export: converts the binary scheduling trace sent by the Final
+ * Project firmware (EDF/trace_ring.h) into Chrome trace JSON.
+ *
+ * The JSON opens in chrome://tracing and in the Perfetto UI
+ * (https://ui.perfetto.dev, "Open trace file"), which imports the Chrome
+ * format directly.
+ *
+ * Capture the UART1 stream to a file with any terminal that can log raw
+ * bytes, then:
+ *
+ *     g++ -O2 -std=c++17 trace_export.cpp -o trace_export
+ *     ./trace_export --name 1=Task1 --name 2=Task2 capture.bin trace.json
+ *
+ * Options:
+ *     --hz N          Timer1 rate, default 59940 (60 MHz / (T1PR + 1), T1PR = 1000)
+ *     --name S=NAME   Display name of task monitor slot S
+ *     --idle-slot S   Slot of the idle task, default 9 (configEDF_MAX_PERIODIC_TASKS + 1)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/* Must match EDF/trace_ring.h. */
+const uint8_t ringEVENT_SWITCH_IN = 1;
+const uint8_t ringEVENT_SWITCH_OUT = 2;
+const uint8_t ringEVENT_READY = 3;
+const uint8_t ringEVENT_DEADLINE = 4;
+const uint8_t ringEVENT_ISR_ENTER = 5;
+const uint8_t ringEVENT_ISR_EXIT = 6;
+const uint8_t ringEVENT_QUEUE_BLOCK_RX = 7;
+const uint8_t ringEVENT_QUEUE_BLOCK_TX = 8;
+const uint8_t ringEVENT_SYNC = 0xff;
+const uint32_t ringSYNC_MAGIC = 0x31435254UL;
+const size_t ringEVENT_SIZE = 8;
+
+/* Chrome trace thread ids: task slots as they are, ISRs above them. */
+const int isrTHREAD_BASE = 1000;
+
+struct TraceEvent
+{
+	uint32_t ulTimestamp;
+	uint8_t ucEvent;
+	uint8_t ucSlot;
+	uint16_t usArg;
+};
+
+uint32_t prvRead32( const uint8_t * p )
+{
+	return ( uint32_t ) p[ 0 ] | ( ( uint32_t ) p[ 1 ] << 8 ) | ( ( uint32_t ) p[ 2 ] << 16 ) | ( ( uint32_t ) p[ 3 ] << 24 );
+}
+
+TraceEvent prvDecode( const uint8_t * p )
+{
+	TraceEvent xEvent;
+
+	xEvent.ulTimestamp = prvRead32( p );
+	xEvent.ucEvent = p[ 4 ];
+	xEvent.ucSlot = p[ 5 ];
+	xEvent.usArg = ( uint16_t ) ( p[ 6 ] | ( p[ 7 ] << 8 ) );
+
+	return xEvent;
+}
+
+class ChromeWriter
+{
+public:
+	ChromeWriter( std::ostream & xOut, double dTicksToUs )
+		: xOut( xOut ), dTicksToUs( dTicksToUs )
+	{
+		xOut << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	}
+
+	void vFinish()
+	{
+		xOut << "\n]}\n";
+	}
+
+	void vThreadName( int iTid, const std::string & xName )
+	{
+		vBegin();
+		xOut << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << iTid
+			 << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << xName << "\"}}";
+	}
+
+	void vSlice( char cPhase, int iTid, const std::string & xName, uint64_t ullTicks )
+	{
+		vBegin();
+		xOut << "{\"ph\":\"" << cPhase << "\",\"pid\":1,\"tid\":" << iTid
+			 << ",\"name\":\"" << xName << "\",\"ts\":" << prvUs( ullTicks ) << "}";
+	}
+
+	void vInstant( int iTid, const std::string & xName, uint64_t ullTicks, const std::string & xArgs = "" )
+	{
+		vBegin();
+		xOut << "{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << iTid
+			 << ",\"name\":\"" << xName << "\",\"ts\":" << prvUs( ullTicks );
+		if( !xArgs.empty() )
+		{
+			xOut << ",\"args\":{" << xArgs << "}";
+		}
+		xOut << "}";
+	}
+
+private:
+	void vBegin()
+	{
+		if( !xFirst )
+		{
+			xOut << ",\n";
+		}
+		xFirst = false;
+	}
+
+	std::string prvUs( uint64_t ullTicks ) const
+	{
+		char cBuffer[ 32 ];
+		std::snprintf( cBuffer, sizeof( cBuffer ), "%.3f", ( double ) ullTicks * dTicksToUs );
+		return cBuffer;
+	}
+
+	std::ostream & xOut;
+	double dTicksToUs;
+	bool xFirst = true;
+};
+
+void prvUsage()
+{
+	std::cerr << "usage: trace_export [--hz N] [--idle-slot SLOT] [--name SLOT=NAME]... capture.bin [trace.json]\n";
+}
+
+} /* namespace */
+
+int main( int argc, char ** argv )
+{
+	double dTimerHz = 59940.0;
+	int iIdleSlot = 9;
+	std::map< int, std::string > xNames;
+	std::vector< std::string > xFiles;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		std::string xArg = argv[ i ];
+
+		if( ( xArg == "--hz" ) && ( i + 1 < argc ) )
+		{
+			dTimerHz = std::atof( argv[ ++i ] );
+		}
+		else if( ( xArg == "--idle-slot" ) && ( i + 1 < argc ) )
+		{
+			iIdleSlot = std::atoi( argv[ ++i ] );
+		}
+		else if( ( xArg == "--name" ) && ( i + 1 < argc ) )
+		{
+			std::string xValue = argv[ ++i ];
+			size_t uxEquals = xValue.find( '=' );
+			if( uxEquals == std::string::npos )
+			{
+				prvUsage();
+				return 2;
+			}
+			xNames[ std::atoi( xValue.substr( 0, uxEquals ).c_str() ) ] = xValue.substr( uxEquals + 1 );
+		}
+		else
+		{
+			xFiles.push_back( xArg );
+		}
+	}
+
+	if( ( xFiles.empty() ) || ( xFiles.size() > 2 ) || ( dTimerHz <= 0.0 ) )
+	{
+		prvUsage();
+		return 2;
+	}
+
+	std::ifstream xIn( xFiles[ 0 ], std::ios::binary );
+	if( !xIn )
+	{
+		std::cerr << "cannot open " << xFiles[ 0 ] << "\n";
+		return 1;
+	}
+	std::vector< uint8_t > xData( ( std::istreambuf_iterator< char >( xIn ) ), std::istreambuf_iterator< char >() );
+
+	std::ofstream xFileOut;
+	if( xFiles.size() == 2 )
+	{
+		xFileOut.open( xFiles[ 1 ] );
+		if( !xFileOut )
+		{
+			std::cerr << "cannot create " << xFiles[ 1 ] << "\n";
+			return 1;
+		}
+	}
+	std::ostream & xOut = ( xFiles.size() == 2 ) ? static_cast< std::ostream & >( xFileOut ) : std::cout;
+
+	ChromeWriter xWriter( xOut, 1e6 / dTimerHz );
+	std::map< int, bool > xRunning;		/* Open slice per thread id. */
+	std::map< int, bool > xNamed;
+	uint64_t ullNow = 0;
+	uint32_t ulLast = 0;
+	bool xHaveTime = false;
+	uint16_t usLastDropped = 0;
+	size_t uxEvents = 0, uxChunks = 0, uxSkipped = 0;
+
+	auto vNameThread = [ & ]( int iTid )
+	{
+		if( !xNamed[ iTid ] )
+		{
+			std::string xName;
+
+			if( iTid >= isrTHREAD_BASE )
+			{
+				xName = "IRQ " + std::to_string( iTid - isrTHREAD_BASE );
+			}
+			else if( xNames.count( iTid ) != 0 )
+			{
+				xName = xNames[ iTid ];
+			}
+			else
+			{
+				xName = ( iTid == iIdleSlot ) ? "idle" : ( iTid == 0 ) ? "untagged" : "slot " + std::to_string( iTid );
+			}
+
+			xWriter.vThreadName( iTid, xName );
+			xNamed[ iTid ] = true;
+		}
+	};
+
+	size_t uxOffset = 0;
+	while( uxOffset + ringEVENT_SIZE <= xData.size() )
+	{
+		TraceEvent xSync = prvDecode( &xData[ uxOffset ] );
+
+		/* Resynchronise byte by byte after line noise or a partial capture. */
+		if( ( xSync.ulTimestamp != ringSYNC_MAGIC ) || ( xSync.ucEvent != ringEVENT_SYNC ) ||
+			( uxOffset + ( ( size_t ) xSync.ucSlot + 1U ) * ringEVENT_SIZE > xData.size() ) )
+		{
+			uxOffset++;
+			uxSkipped++;
+			continue;
+		}
+
+		uxOffset += ringEVENT_SIZE;
+		uxChunks++;
+
+		for( unsigned x = 0; x < xSync.ucSlot; x++, uxOffset += ringEVENT_SIZE )
+		{
+			TraceEvent xEvent = prvDecode( &xData[ uxOffset ] );
+
+			/* Unwrap T1TC into a 64 bit time line starting at 0. */
+			if( !xHaveTime )
+			{
+				ulLast = xEvent.ulTimestamp;
+				xHaveTime = true;
+			}
+			ullNow += ( uint32_t ) ( xEvent.ulTimestamp - ulLast );
+			ulLast = xEvent.ulTimestamp;
+
+			int iTid = xEvent.ucSlot;
+			uxEvents++;
+
+			switch( xEvent.ucEvent )
+			{
+				case ringEVENT_SWITCH_IN:
+					vNameThread( iTid );
+					xWriter.vSlice( 'B', iTid, "running", ullNow );
+					xRunning[ iTid ] = true;
+					break;
+
+				case ringEVENT_SWITCH_OUT:
+					if( xRunning[ iTid ] )
+					{
+						xWriter.vSlice( 'E', iTid, "running", ullNow );
+						xRunning[ iTid ] = false;
+					}
+					break;
+
+				case ringEVENT_READY:
+					vNameThread( iTid );
+					xWriter.vInstant( iTid, "ready", ullNow );
+					break;
+
+				case ringEVENT_DEADLINE:
+				{
+					int iLateness = ( int16_t ) xEvent.usArg;
+					vNameThread( iTid );
+					xWriter.vInstant( iTid, ( iLateness > 0 ) ? "deadline miss" : "job done", ullNow,
+									  "\"lateness_ticks\":" + std::to_string( iLateness ) );
+					break;
+				}
+
+				case ringEVENT_ISR_ENTER:
+					iTid += isrTHREAD_BASE;
+					vNameThread( iTid );
+					xWriter.vSlice( 'B', iTid, "isr", ullNow );
+					xRunning[ iTid ] = true;
+					break;
+
+				case ringEVENT_ISR_EXIT:
+					iTid += isrTHREAD_BASE;
+					if( xRunning[ iTid ] )
+					{
+						xWriter.vSlice( 'E', iTid, "isr", ullNow );
+						xRunning[ iTid ] = false;
+					}
+					break;
+
+				case ringEVENT_QUEUE_BLOCK_RX:
+				case ringEVENT_QUEUE_BLOCK_TX:
+				{
+					char cQueue[ 16 ];
+					std::snprintf( cQueue, sizeof( cQueue ), "\"0x%04x\"", xEvent.usArg );
+					vNameThread( iTid );
+					xWriter.vInstant( iTid, ( xEvent.ucEvent == ringEVENT_QUEUE_BLOCK_RX ) ? "block on receive" : "block on send",
+									  ullNow, std::string( "\"queue\":" ) + cQueue );
+					break;
+				}
+
+				default:
+					break;
+			}
+		}
+
+		/* The firmware counts events it had to drop because the ring was full. */
+		if( xSync.usArg != usLastDropped )
+		{
+			xWriter.vInstant( 0, "events dropped", ullNow,
+							  "\"count\":" + std::to_string( ( uint16_t ) ( xSync.usArg - usLastDropped ) ) );
+			usLastDropped = xSync.usArg;
+		}
+	}
+
+	xWriter.vFinish();
+
+	std::cerr << uxEvents << " events in " << uxChunks << " chunks";
+	if( uxSkipped != 0U )
+	{
+		std::cerr << ", " << uxSkipped << " bytes skipped while resynchronising";
+	}
+	std::cerr << "\n";
+
+	return 0;
+}